@@ -1,18 +1,10 @@
 #include "Application.h"
+#include <algorithm>
 #include <iostream>
 #include <format>
-#include <fstream>
 #include <chrono>
-
-#define STB_IMAGE_IMPLEMENTATION
-
-#include <stb/image.h>
-
-#define TINYOBJLOADER_IMPLEMENTATION
-
-#include <tiny_obj_loader.h>
-
-#include <unordered_map>
+#include <cmath>
+#include <thread>
 
 /* Currently using regions, just so it's easier for me to
    see what's going on since I don't want to abstract
@@ -25,9 +17,32 @@ namespace Haus {
         glm::mat3 normalInverse;
     };
 
+    // Matches the push constant blocks of default.vert and default.frag, the quantization is only read by the packed
+    // variants and the layers by the fragment shader
     struct MyConstant {
         glm::vec3 Position;
+        alignas(16) VertexQuantization Quantization;
+        uint32_t ColorLayer;
+        uint32_t NormalMapLayer;
     };
+
+    // Compressed levels cannot be blitted, those images get exactly the levels that are stored
+    static uint32_t GetTextureMipLevels(const TextureView &texture) {
+        if (BlockCompressor::IsBlockCompressed(texture.Format))
+            return static_cast<uint32_t>(texture.Mips.size());
+
+        return TextureImporter::GetMipCount(texture.Width, texture.Height);
+    }
+
+    // Generated levels are not stored, their size follows from the top level
+    static std::vector<uint64_t> GetTextureLevelSizes(const TextureView &texture) {
+        std::vector<uint64_t> sizes(GetTextureMipLevels(texture));
+        for (uint32_t level = 0; level < sizes.size(); level++)
+            sizes[level] = level < texture.Mips.size() ? texture.Mips[level].Size
+                                                       : std::max(texture.Mips[0].Size >> (2 * level), uint64_t(1));
+
+        return sizes;
+    }
     /*const std::vector<Vertex> vertices = {
             // Front face
             {{0.5f,  0.5f,  0.5f},  {1.0f, 0.0f,  0.0f},  {1.0f, 1.0f}, {0.0f,  0.0f,  1.0f}}, // 0
@@ -94,7 +109,8 @@ namespace Haus {
 
 #pragma region APPLICATION
 
-    Application::Application(ApplicationSpecification &specification) : m_Specification(specification) {}
+    Application::Application(ApplicationSpecification &specification)
+            : m_Specification(specification), m_TextureResidency(specification.TextureBudget) {}
 
     void Application::Run() {
         std::cout << std::format("Starting Application {}", m_Specification.Name) << "\n";
@@ -143,6 +159,12 @@ namespace Haus {
         if (key == GLFW_KEY_E && action == GLFW_RELEASE)
             app->m_WireframeEnabled = !app->m_WireframeEnabled;
 
+        if (key == GLFW_KEY_C && action == GLFW_RELEASE)
+            app->m_MeshletCullingEnabled = !app->m_MeshletCullingEnabled;
+
+        if (key == GLFW_KEY_L && action == GLFW_RELEASE)
+            app->m_LodSelectionEnabled = !app->m_LodSelectionEnabled;
+
 
         // Works and sometimes not, so that means I am doing something wrong Yeee!!
         // TODO: Either try to fix this or leave it for now.
@@ -165,7 +187,12 @@ namespace Haus {
 
     void Application::InitVulkan() {
         std::cout << "Initializing Vulkan" << "\n";
+
+        // Decoding runs on the pool while the device is being set up, once it is known which formats it samples
         m_VulkanContext = new VulkanContext();
+        m_BlockCompression = m_VulkanContext->GetVulkanPhysicalDevice()->SupportsBlockCompression();
+        StartAssetLoads();
+
         m_MsaaSamples = GetMaxUsableSampleCount();
         std::cout << "MSAA: " << to_string(m_MsaaSamples) << std::endl;
 
@@ -175,17 +202,13 @@ namespace Haus {
         CreateImageViews();
         CreateRenderPass();
         CreateDescriptorSetLayout();
-        CreateGraphicsPipeline();
         CreateCommandPool();
+        CreatePlaceholderAssets();
+        CreateGraphicsPipeline();
         CreateColorResources();
         CreateDepthResources();
         CreateFramebuffers();
-        CreateTextureImage();
-        CreateTextureImageView();
         CreateTextureSampler();
-        LoadModel();
-        CreateVertexBuffer();
-        CreateIndexBuffer();
         CreateUniformBuffers();
         CreateDescriptorPool();
         CreateDescriptorSets();
@@ -193,63 +216,358 @@ namespace Haus {
         CreateSyncObjects();
     }
 
-    void Application::LoadModel() {
-        std::string modelFile = "assets/models/Moon/Moon 2K.obj";
-        tinyobj::ObjReader reader;
+    void Application::StartAssetLoads() {
+        m_MeshAsset.Source = "assets/models/Moon/Moon 2K.obj";
+        // One material per instance. Both use the Moon's textures until there is a second set of the same size, so
+        // they share a layer and the textures stay mapped and streamed
+        m_TextureAsset.Sources = {"assets/models/Moon/Textures/Diffuse_2K.png",
+                                  "assets/models/Moon/Textures/Diffuse_2K.png"};
+        m_NormalMapAsset.Sources = {"assets/models/Moon/Textures/Bump_2K.png",
+                                    "assets/models/Moon/Textures/Bump_2K.png"};
+        m_Materials.resize(m_TextureAsset.Sources.size());
+
+        // One mapping and index lookups instead of opening every entry, the loose files are the fallback
+        std::filesystem::path archivePath = AssetArchive::GetArchivePath("assets");
+        if (std::filesystem::exists(archivePath)) {
+            try {
+                m_AssetArchive = std::make_unique<AssetArchive>(archivePath);
+            } catch (std::exception &exception) {
+                std::cerr << exception.what() << "\n";
+            }
+        }
 
-        tinyobj::ObjReaderConfig config{};
-        config.triangulate = true;
-        config.mtl_search_path = "models/Moon";
+        m_AssetTasks.push_back(Spawn(LoadMeshAsync(m_MeshAsset.Source, m_MeshAsset.Generation)));
+        m_AssetTasks.push_back(Spawn(LoadTextureAsync(m_TextureAsset.Sources, m_TextureAsset.Generation)));
+        m_AssetTasks.push_back(Spawn(LoadNormalMapAsync(m_NormalMapAsset.Sources, m_NormalMapAsset.Generation)));
 
-        if (!reader.ParseFromFile(modelFile, config)) {
-            if (!reader.Error().empty()) {
-                std::cerr << "TinyObjReader: " << reader.Error();
-            }
-            exit(1);
+        if (std::filesystem::is_directory("assets"))
+            m_FileWatcher = std::make_unique<FileWatcher>("assets");
+    }
+
+    const AssetArchive *Application::GetAssetArchive(uint64_t generation) const {
+        return generation == 0 ? m_AssetArchive.get() : nullptr;
+    }
+
+    Task<> Application::LoadMeshAsync(std::filesystem::path source, uint64_t generation) {
+        // Geometry first, the placeholder silhouette is further off than the placeholder color
+        co_await Schedule(m_ThreadPool, TaskPriority::High, m_AssetCancellation);
+        LoadedMesh mesh = AssetLoader::LoadMesh(source, AssetCompiler::GetMeshOptions(), &m_ThreadPool,
+                                                GetAssetArchive(generation));
+
+        // The command pool and the graphics queue are only used from the main thread
+        co_await m_FrameTasks.Schedule(m_AssetCancellation);
+        if (generation != m_MeshAsset.Generation)
+            co_return;
+
+        MeshView view = mesh.View();
+        PendingUpload upload = BeginUpload();
+
+        // Frames recorded after the submit are ordered behind the copy on the queue, so the mesh can switch now
+        if (view.VertexData.size_bytes() <= m_GpuMesh.VertexBufferSize &&
+            view.IndexData.size_bytes() <= m_GpuMesh.IndexBufferSize) {
+            RecordMeshCopy(view, m_GpuMesh, upload);
+            SubmitUpload(upload);
+            SetMesh(std::move(mesh));
+
+            co_await WaitForUpload(upload);
+            co_return;
         }
 
-        if (!reader.Warning().empty()) {
-            std::cout << "TinyObjReader: " << reader.Warning();
+        GpuMesh gpuMesh = RecordMeshUpload(view, upload);
+        SubmitUpload(upload);
+
+        co_await WaitForUpload(upload);
+        if (generation != m_MeshAsset.Generation) {
+            // Never bound, the upload fence was the last use
+            DestroyMesh(gpuMesh);
+            co_return;
         }
 
-        auto &attrib = reader.GetAttrib();
-        auto &shapes = reader.GetShapes();
-        auto &materials = reader.GetMaterials();
+        SwapInMesh(gpuMesh, std::move(mesh));
+    }
 
-        std::unordered_map<Vertex, uint32_t> uniqueVertices{};
+    Task<> Application::LoadTextureAsync(std::vector<std::filesystem::path> sources, uint64_t generation) {
+        co_await Schedule(m_ThreadPool, TaskPriority::Normal, m_AssetCancellation);
+        std::vector<uint32_t> layers;
+        LoadedTexture texture = LoadTextureArray(sources, AssetCompiler::GetTextureOptions(m_BlockCompression),
+                                                 GetAssetArchive(generation), layers);
+
+        co_await m_FrameTasks.Schedule(m_AssetCancellation);
+        if (generation != m_TextureAsset.Generation)
+            co_return;
+
+        TextureView view = texture.View();
+        PendingUpload upload = BeginUpload();
+
+        // Same image and view, the descriptor sets stay as they are. Only the resident levels are replaced, which
+        // needs every level stored unless the whole chain is resident.
+        if (view.Format == m_Texture.Format && view.Width == m_Texture.Width && view.Height == m_Texture.Height &&
+            view.Layers == m_Texture.Layers && GetTextureMipLevels(view) == m_Texture.MipLevels &&
+            (view.Mips.size() == m_Texture.MipLevels || m_Texture.BaseMip == 0)) {
+            RecordTextureCopy(view, m_Texture, vk::ImageLayout::eShaderReadOnlyOptimal, upload);
+            SubmitUpload(upload);
+            for (size_t material = 0; material < m_Materials.size(); material++)
+                m_Materials[material].ColorLayer = layers[material];
+            m_LoadedTexture = std::move(texture);
+
+            co_await WaitForUpload(upload);
+            co_return;
+        }
 
-        for (const auto &shape: shapes) {
-            for (const auto &index: shape.mesh.indices) {
-                Vertex vertex{};
-                vertex.Position = {
-                        attrib.vertices[3 * index.vertex_index + 0],
-                        attrib.vertices[3 * index.vertex_index + 1],
-                        attrib.vertices[3 * index.vertex_index + 2],
-                };
+        GpuTexture gpuTexture = RecordTextureUpload(view, GetTextureTailMip(view), upload);
+        SubmitUpload(upload);
 
-                vertex.Normal = {
-                        attrib.normals[3 * index.normal_index + 0],
-                        attrib.normals[3 * index.normal_index + 1],
-                        attrib.normals[3 * index.normal_index + 2],
-                };
+        co_await WaitForUpload(upload);
+        if (generation != m_TextureAsset.Generation) {
+            DestroyTexture(gpuTexture);
+            co_return;
+        }
+
+        SwapInTexture(m_Texture, gpuTexture);
+        m_TextureResidency.Unregister(m_TextureResident);
+        m_TextureResident = m_TextureResidency.Register(GetTextureLevelSizes(view), GetTextureTailMip(view),
+                                                        gpuTexture.BaseMip, m_FrameNumber);
+        for (size_t material = 0; material < m_Materials.size(); material++)
+            m_Materials[material].ColorLayer = layers[material];
+        m_LoadedTexture = std::move(texture);
+    }
+
+    Task<> Application::StreamTextureAsync(uint64_t generation, uint32_t baseMip) {
+        PendingUpload upload = BeginUpload();
+        GpuTexture gpuTexture = RecordTextureRebase(m_LoadedTexture.View(), m_Texture, baseMip, upload);
+        SubmitUpload(upload);
+
+        co_await WaitForUpload(upload);
+        m_TextureStreaming = false;
+
+        // Reloaded in the meantime, the copy belongs to the old source and was accounted for the levels it holds
+        if (generation != m_TextureAsset.Generation) {
+            if (m_TextureResident != 0)
+                m_TextureResidency.SetBaseMip(m_TextureResident, m_Texture.BaseMip);
+
+            DestroyTexture(gpuTexture);
+            co_return;
+        }
+
+        SwapInTexture(m_Texture, gpuTexture);
+    }
 
-                vertex.TextureCoord = {
-                        attrib.texcoords[2 * index.texcoord_index + 0],
-                        attrib.texcoords[2 * index.texcoord_index + 1],
+    Task<> Application::LoadNormalMapAsync(std::vector<std::filesystem::path> sources, uint64_t generation) {
+        co_await Schedule(m_ThreadPool, TaskPriority::Normal, m_AssetCancellation);
+        std::vector<uint32_t> layers;
+        LoadedTexture texture = LoadTextureArray(sources, AssetCompiler::GetNormalMapOptions(m_BlockCompression),
+                                                 GetAssetArchive(generation), layers);
+
+        co_await m_FrameTasks.Schedule(m_AssetCancellation);
+        if (generation != m_NormalMapAsset.Generation)
+            co_return;
+
+        TextureView view = texture.View();
+        PendingUpload upload = BeginUpload();
+        GpuTexture gpuTexture = RecordTextureUpload(view, 0, upload);
+        SubmitUpload(upload);
+
+        co_await WaitForUpload(upload);
+        if (generation != m_NormalMapAsset.Generation) {
+            DestroyTexture(gpuTexture);
+            co_return;
+        }
+
+        SwapInTexture(m_NormalMap, gpuTexture);
+        m_TextureResidency.Unregister(m_NormalMapResident);
+        m_NormalMapResident = m_TextureResidency.Register(GetTextureLevelSizes(view), 0, 0, m_FrameNumber);
+        for (size_t material = 0; material < m_Materials.size(); material++)
+            m_Materials[material].NormalMapLayer = layers[material];
+    }
+
+    LoadedTexture Application::LoadTextureArray(std::span<const std::filesystem::path> sources,
+                                                const TextureImportOptions &options, const AssetArchive *archive,
+                                                std::vector<uint32_t> &layers) {
+        // Materials sharing a texture share its layer, it is only loaded and packed once
+        std::vector<std::filesystem::path> distinct;
+        std::vector<uint32_t> distinctIndices;
+        for (const std::filesystem::path &source: sources) {
+            auto match = std::ranges::find(distinct, source);
+            distinctIndices.push_back(static_cast<uint32_t>(match - distinct.begin()));
+            if (match == distinct.end())
+                distinct.push_back(source);
+        }
+
+        std::vector<LoadedTexture> textures;
+        for (const std::filesystem::path &source: distinct) {
+            LoadedTexture &texture = textures.emplace_back(
+                    AssetLoader::LoadTexture(source, options, &m_ThreadPool, archive));
+
+            // Baked entries shipped without their source stay block compressed, whatever the options ask for
+            if (!m_BlockCompression && BlockCompressor::IsBlockCompressed(texture.View().Format)) {
+                texture.Imported = BlockCompressor::Decompress(texture.View(), &m_ThreadPool);
+                texture.Cached.reset();
+            }
+
+            // Entries stored without their chain get it here on the pool, so the upload never blits on the GPU
+            TextureView loaded = texture.View();
+            if (loaded.Mips.size() < GetTextureMipLevels(loaded) && MipGenerator::IsFormatSupported(loaded.Format)) {
+                TextureData complete{
+                        .Format = loaded.Format,
+                        .Width = loaded.Width,
+                        .Height = loaded.Height,
+                        .Mips = {{0, loaded.Mips[0].Size, loaded.Width, loaded.Height}}
                 };
+                std::span<const std::byte> firstLevel = loaded.Data.subspan(loaded.Mips[0].Offset,
+                                                                            loaded.Mips[0].Size);
+                complete.Pixels.assign(firstLevel.begin(), firstLevel.end());
 
-                vertex.Color = {1.0f, 1.0f, 1.0f};
+                MipGenerator::Generate(complete, options.Filter, &m_ThreadPool);
+                texture.Cached.reset();
+                texture.Imported = std::move(complete);
+            }
+        }
 
-                if (uniqueVertices.count(vertex) == 0) {
-                    uniqueVertices[vertex] = static_cast<uint32_t>(vertices.size());
-                    vertices.push_back(vertex);
-                }
+        if (textures.size() == 1) {
+            layers.assign(sources.size(), 0);
+            return std::move(textures[0]);
+        }
+
+        std::vector<TextureView> views;
+        for (const LoadedTexture &texture: textures)
+            views.push_back(texture.View());
+
+        // One array is bound per kind of texture, so every material has to land in the same one
+        TexturePacking packing = TexturePacker::Plan(views, MAX_TEXTURE_LAYERS);
+        if (packing.Arrays.size() != 1)
+            throw std::runtime_error("Application: Material textures differ in format, size or mip count");
+
+        layers.clear();
+        for (uint32_t index: distinctIndices)
+            layers.push_back(packing.Slots[index].Layer);
+
+        LoadedTexture packed;
+        packed.Imported = TexturePacker::Build(packing.Arrays[0], views, &m_ThreadPool);
+        return packed;
+    }
+
+    uint32_t Application::GetTextureTailMip(const TextureView &texture) const {
+        // Generated levels are blitted from the top one, so those textures are uploaded whole
+        uint32_t levels = GetTextureMipLevels(texture);
+        if (texture.Mips.size() < levels)
+            return 0;
 
-                indices.push_back(uniqueVertices[vertex]);
+        uint32_t level = 0;
+        while (level + 1 < levels &&
+               std::max(texture.Mips[level].Width, texture.Mips[level].Height) > TEXTURE_TAIL_SIZE)
+            level++;
+
+        return level;
+    }
+
+    uint32_t Application::GetWantedTextureMip() const {
+        // The texture wraps around the mesh, so the visible half spans about one projected diameter
+        float texels = 2.0f * m_TextureScreenSize;
+        float size = static_cast<float>(std::max(m_Texture.Width, m_Texture.Height));
+        if (!(texels < size))
+            return 0;
+
+        auto level = static_cast<uint32_t>(std::floor(std::log2(size / std::max(texels, 1.0f))));
+        return std::min(level, m_Texture.MipLevels - 1);
+    }
+
+    void Application::UpdateTextureStreaming() {
+        if (m_TextureStreaming || m_TextureResident == 0)
+            return;
+
+        // Over budget after a reload or a smaller budget, textures not drawn lately give up their finest levels
+        for (const TextureEviction &eviction: m_TextureResidency.Trim(m_FrameNumber))
+            RebaseTexture(eviction);
+
+        if (m_TextureStreaming || m_Texture.BaseMip == 0 || GetWantedTextureMip() >= m_Texture.BaseMip)
+            return;
+
+        // One level at a time, each step is a small upload and the detail sharpens progressively
+        std::optional<std::vector<TextureEviction>> evictions =
+                m_TextureResidency.MakeRoom(m_TextureResident, m_Texture.BaseMip - 1, m_FrameNumber);
+        if (!evictions)
+            return;
+
+        for (const TextureEviction &eviction: *evictions)
+            RebaseTexture(eviction);
+
+        RebaseTexture({m_TextureResident, m_Texture.BaseMip - 1});
+    }
+
+    void Application::RebaseTexture(const TextureEviction &rebase) {
+        // m_Texture is the only texture streamed so far, the normal map's entry never gives up levels
+        if (rebase.Texture != m_TextureResident)
+            return;
+
+        m_TextureStreaming = true;
+        m_AssetTasks.push_back(Spawn(StreamTextureAsync(m_TextureAsset.Generation, rebase.BaseMip)));
+    }
+
+    void Application::PollFileChanges() {
+        if (!m_FileWatcher)
+            return;
+
+        // The runtime stores cache entries next to the sources, those only count for baked assets
+        auto changed = [](const std::filesystem::path &path, const std::filesystem::path &source,
+                          const std::filesystem::path &cachePath) {
+            if (path == source)
+                return true;
+
+            return path == cachePath && !std::filesystem::exists(source);
+        };
+
+        // Any layer of an array changing reloads the whole array
+        auto textureChanged = [&](const std::filesystem::path &path, const TextureArraySlot &asset) {
+            return std::ranges::any_of(asset.Sources, [&](const std::filesystem::path &source) {
+                return changed(path, source, TextureCache::GetCachePath(source));
+            });
+        };
+
+        for (const std::filesystem::path &path: m_FileWatcher->Poll()) {
+            if (changed(path, m_MeshAsset.Source, MeshCache::GetCachePath(m_MeshAsset.Source))) {
+                std::cout << std::format("Reloading {}", m_MeshAsset.Source.string()) << "\n";
+                m_AssetTasks.push_back(Spawn(LoadMeshAsync(m_MeshAsset.Source, ++m_MeshAsset.Generation)));
+            } else if (textureChanged(path, m_TextureAsset)) {
+                std::cout << std::format("Reloading {}", path.string()) << "\n";
+                m_AssetTasks.push_back(Spawn(LoadTextureAsync(m_TextureAsset.Sources, ++m_TextureAsset.Generation)));
+            } else if (textureChanged(path, m_NormalMapAsset)) {
+                std::cout << std::format("Reloading {}", path.string()) << "\n";
+                m_AssetTasks.push_back(
+                        Spawn(LoadNormalMapAsync(m_NormalMapAsset.Sources, ++m_NormalMapAsset.Generation)));
             }
         }
     }
 
+    void Application::PollAssetTasks() {
+        std::erase_if(m_AssetTasks, [](std::future<void> &task) {
+            if (task.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+                return false;
+
+            try {
+                task.get();
+            } catch (const TaskCancelled &) {
+            } catch (const std::exception &exception) {
+                std::cerr << "Failed to load asset: " << exception.what() << "\n";
+            }
+
+            return true;
+        });
+    }
+
+    void Application::FinishAssetTasks() {
+        // Tasks stop at their next hop, uploads already submitted run to completion once the device is idle
+        m_AssetCancellation.Cancel();
+        m_Device.waitIdle();
+
+        while (!m_AssetTasks.empty()) {
+            m_FrameTasks.Drain();
+            PollAssetTasks();
+
+            if (!m_AssetTasks.empty())
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
     void Application::CreateSurface() {
         if (glfwCreateWindowSurface(VulkanContext::GetInstance(), m_Window->GetNativeWindow(), nullptr,
                                     reinterpret_cast<VkSurfaceKHR *>(&m_Surface)))
@@ -268,6 +586,7 @@ namespace Haus {
                 .sampleRateShading = vk::True,
                 .fillModeNonSolid = vk::True,
                 .samplerAnisotropy = vk::True,
+                .textureCompressionBC = m_BlockCompression ? vk::True : vk::False,
         };
 
         std::vector<const char *> enabledExtensions = {"VK_KHR_swapchain"};
@@ -405,8 +724,8 @@ namespace Haus {
         m_SwapchainImageViews.resize(m_SwapchainImages.size());
 
         for (size_t i = 0; i < m_SwapchainImages.size(); i++) {
-            m_SwapchainImageViews[i] = CreateImageView(m_SwapchainImages[i], m_SwapchainImageFormat,
-                                                       vk::ImageAspectFlagBits::eColor, 1);
+            m_SwapchainImageViews[i] = CreateImageView(m_SwapchainImages[i], vk::ImageViewType::e2D,
+                                                       m_SwapchainImageFormat, vk::ImageAspectFlagBits::eColor, 1, 1);
         }
     }
 
@@ -495,25 +814,13 @@ namespace Haus {
             throw std::runtime_error("Failed to create render pass");
     }
 
-    static std::vector<char> ReadFile(const std::string &filename) {
-        std::ifstream file(filename, std::ios::ate | std::ios::binary);
+    vk::ShaderModule Application::CreateShaderModule(const std::filesystem::path &path) {
+        // Mappings are page aligned, so the code can be handed to the driver in place
+        MappedFile code(path, MappedFileAccess::WillNeed);
 
-        if (!file.is_open())
-            throw std::runtime_error("Failed to open file");
-
-        size_t fileSize = (size_t) file.tellg();
-        std::vector<char> buffer(fileSize);
-        file.seekg(0);
-        file.read(buffer.data(), fileSize);
-        file.close();
-
-        return buffer;
-    }
-
-    vk::ShaderModule Application::CreateShaderModule(const std::vector<char> &code) {
         vk::ShaderModuleCreateInfo createInfo{
-                .codeSize = code.size(),
-                .pCode = reinterpret_cast<const uint32_t *>(code.data())
+                .codeSize = code.GetSize(),
+                .pCode = reinterpret_cast<const uint32_t *>(code.GetData())
         };
 
         vk::ShaderModule shaderModule;
@@ -538,8 +845,15 @@ namespace Haus {
                 .stageFlags = vk::ShaderStageFlagBits::eFragment
         };
 
-        std::array<vk::DescriptorSetLayoutBinding, 2> bindings = {
-                uboLayoutBinding, samplerLayoutBinding
+        vk::DescriptorSetLayoutBinding normalMapLayoutBinding{
+                .binding = 2,
+                .descriptorType = vk::DescriptorType::eCombinedImageSampler,
+                .descriptorCount = 1,
+                .stageFlags = vk::ShaderStageFlagBits::eFragment
+        };
+
+        std::array<vk::DescriptorSetLayoutBinding, 3> bindings = {
+                uboLayoutBinding, samplerLayoutBinding, normalMapLayoutBinding
         };
 
         vk::DescriptorSetLayoutCreateInfo layoutInfo{
@@ -552,11 +866,9 @@ namespace Haus {
     }
 
     void Application::CreateGraphicsPipeline() {
-        auto vertexShaderCode = ReadFile("shaders/vert.spv");
-        auto fragmentShaderCode = ReadFile("shaders/frag.spv");
-
-        vk::ShaderModule vertexShaderModule = CreateShaderModule(vertexShaderCode);
-        vk::ShaderModule fragmentShaderModule = CreateShaderModule(fragmentShaderCode);
+        vk::ShaderModule vertexShaderModule =
+                CreateShaderModule(std::format("shaders/vert{}.spv", m_Mesh.Layout.GetShaderVariant()));
+        vk::ShaderModule fragmentShaderModule = CreateShaderModule("shaders/frag.spv");
 
         vk::PipelineShaderStageCreateInfo vertexShaderStageInfo{
                 .stage = vk::ShaderStageFlagBits::eVertex,
@@ -585,12 +897,14 @@ namespace Haus {
                 .pDynamicStates = dynamicStates.data()
         };
 
-        auto bindingDescription = Vertex::GetBindingDescription();
-        auto attributeDescriptions = Vertex::GetAttributeDescriptions();
+        // The default shaders read every attribute, a depth-only pipeline would pass {false, false, false, false}
+        VertexShaderInputs shaderInputs{};
+        auto bindingDescriptions = m_Mesh.Layout.GetBindingDescriptions(shaderInputs);
+        auto attributeDescriptions = m_Mesh.Layout.GetAttributeDescriptions(shaderInputs);
 
         vk::PipelineVertexInputStateCreateInfo vertexInputInfo{
-                .vertexBindingDescriptionCount = 1,
-                .pVertexBindingDescriptions = &bindingDescription,
+                .vertexBindingDescriptionCount = static_cast<uint32_t>(bindingDescriptions.size()),
+                .pVertexBindingDescriptions = bindingDescriptions.data(),
                 .vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size()),
                 .pVertexAttributeDescriptions = attributeDescriptions.data()
         };
@@ -641,7 +955,7 @@ namespace Haus {
         };
 
         vk::PushConstantRange pushConstantRange{};
-        pushConstantRange.stageFlags = vk::ShaderStageFlagBits::eVertex;
+        pushConstantRange.stageFlags = vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment;
         pushConstantRange.offset = 0;
         pushConstantRange.size = sizeof(MyConstant);
 
@@ -749,23 +1063,27 @@ namespace Haus {
 
     void Application::CreateColorResources() {
         vk::Format format = m_SwapchainImageFormat;
-        CreateImage(m_SwapchainExtent.width, m_SwapchainExtent.height, 1, m_MsaaSamples, format,
+        CreateImage(m_SwapchainExtent.width, m_SwapchainExtent.height, 1, 1, m_MsaaSamples, format,
                     vk::ImageTiling::eOptimal,
                     vk::ImageUsageFlagBits::eTransientAttachment | vk::ImageUsageFlagBits::eColorAttachment,
                     vk::MemoryPropertyFlagBits::eDeviceLocal, m_ColorImage, m_ColorImageMemory);
 
-        m_ColorImageView = CreateImageView(m_ColorImage, format, vk::ImageAspectFlagBits::eColor, 1);
+        m_ColorImageView = CreateImageView(m_ColorImage, vk::ImageViewType::e2D, format,
+                                           vk::ImageAspectFlagBits::eColor, 1, 1);
     }
 
     void Application::CreateDepthResources() {
-        CreateImage(m_SwapchainExtent.width, m_SwapchainExtent.height, 1, m_MsaaSamples,
+        CreateImage(m_SwapchainExtent.width, m_SwapchainExtent.height, 1, 1, m_MsaaSamples,
                     vk::Format::eD32Sfloat,
                     vk::ImageTiling::eOptimal, vk::ImageUsageFlagBits::eDepthStencilAttachment,
                     vk::MemoryPropertyFlagBits::eDeviceLocal, m_DepthImage, m_DepthImageMemory);
-        m_DepthImageView = CreateImageView(m_DepthImage, vk::Format::eD32Sfloat, vk::ImageAspectFlagBits::eDepth, 1);
+        m_DepthImageView = CreateImageView(m_DepthImage, vk::ImageViewType::e2D, vk::Format::eD32Sfloat,
+                                           vk::ImageAspectFlagBits::eDepth, 1, 1);
 
-        TransitionImageLayout(m_DepthImage, vk::Format::eD32Sfloat, vk::ImageLayout::eUndefined,
+        vk::CommandBuffer commandBuffer = BeginSingleTimeCommands();
+        TransitionImageLayout(commandBuffer, m_DepthImage, vk::Format::eD32Sfloat, vk::ImageLayout::eUndefined,
                               vk::ImageLayout::eDepthStencilAttachmentOptimal, 1);
+        EndSingleTimeCommands(commandBuffer);
     }
 
     vk::CommandBuffer Application::BeginSingleTimeCommands() {
@@ -802,35 +1120,343 @@ namespace Haus {
         m_Device.freeCommandBuffers(m_CommandPool, 1, &commandBuffer);
     }
 
-    void Application::CopyBufferToImage(vk::Buffer buffer, vk::Image image, uint32_t width, uint32_t height) {
-        vk::CommandBuffer commandBuffer = BeginSingleTimeCommands();
+    PendingUpload Application::BeginUpload() {
+        PendingUpload upload{};
+        upload.CommandBuffer = BeginSingleTimeCommands();
 
-        vk::BufferImageCopy region{
-                .bufferOffset = 0,
-                .bufferRowLength = 0,
-                .bufferImageHeight = 0,
-                .imageSubresource {
-                        .aspectMask = vk::ImageAspectFlagBits::eColor,
-                        .mipLevel = 0,
-                        .baseArrayLayer = 0,
-                        .layerCount = 1
-                },
-                .imageOffset {0, 0, 0},
-                .imageExtent {
-                        .width = width,
-                        .height = height,
-                        .depth = 1
-                }
+        vk::FenceCreateInfo fenceInfo{};
+        if (m_Device.createFence(&fenceInfo, nullptr, &upload.Fence) != vk::Result::eSuccess)
+            throw std::runtime_error("Failed to create upload fence");
+
+        return upload;
+    }
+
+    void Application::SubmitUpload(PendingUpload &upload) {
+        upload.CommandBuffer.end();
+
+        vk::SubmitInfo submitInfo{
+                .commandBufferCount = 1,
+                .pCommandBuffers = &upload.CommandBuffer
         };
 
-        commandBuffer.copyBufferToImage(buffer, image, vk::ImageLayout::eTransferDstOptimal, 1, &region);
+        if (m_GraphicsQueue.submit(1, &submitInfo, upload.Fence) != vk::Result::eSuccess)
+            throw std::runtime_error("Failed to submit upload command buffer");
+    }
+
+    Task<> Application::WaitForUpload(PendingUpload &upload) {
+        co_await m_FrameTasks.Until([this, &upload]() {
+            return m_Device.getFenceStatus(upload.Fence) == vk::Result::eSuccess;
+        });
 
-        EndSingleTimeCommands(commandBuffer);
+        FinishUpload(upload);
+    }
+
+    void Application::FinishUpload(PendingUpload &upload) {
+        for (size_t i = 0; i < upload.StagingBuffers.size(); i++) {
+            m_Device.destroyBuffer(upload.StagingBuffers[i]);
+            m_Device.freeMemory(upload.StagingBuffersMemory[i]);
+        }
+        m_Device.freeCommandBuffers(m_CommandPool, 1, &upload.CommandBuffer);
+        m_Device.destroyFence(upload.Fence);
+    }
+
+    vk::Buffer Application::CreateStagingBuffer(std::span<const std::byte> data, PendingUpload &upload) {
+        vk::Buffer stagingBuffer;
+        vk::DeviceMemory stagingBufferMemory;
+        CreateBuffer(data.size_bytes(), vk::BufferUsageFlagBits::eTransferSrc,
+                     vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+                     stagingBuffer, stagingBufferMemory);
+
+        void *mapped = m_Device.mapMemory(stagingBufferMemory, 0, data.size_bytes());
+        memcpy(mapped, data.data(), data.size_bytes());
+        m_Device.unmapMemory(stagingBufferMemory);
+
+        upload.StagingBuffers.push_back(stagingBuffer);
+        upload.StagingBuffersMemory.push_back(stagingBufferMemory);
+
+        return stagingBuffer;
+    }
+
+    GpuMesh Application::RecordMeshUpload(const MeshView &mesh, PendingUpload &upload) {
+        GpuMesh gpuMesh{
+                .VertexBufferSize = mesh.VertexData.size_bytes(),
+                .IndexBufferSize = mesh.IndexData.size_bytes()
+        };
+
+        CreateBuffer(gpuMesh.VertexBufferSize,
+                     vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eVertexBuffer,
+                     vk::MemoryPropertyFlagBits::eDeviceLocal, gpuMesh.VertexBuffer, gpuMesh.VertexBufferMemory);
+        CreateBuffer(gpuMesh.IndexBufferSize,
+                     vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eIndexBuffer,
+                     vk::MemoryPropertyFlagBits::eDeviceLocal, gpuMesh.IndexBuffer, gpuMesh.IndexBufferMemory);
+
+        RecordMeshCopy(mesh, gpuMesh, upload);
+
+        return gpuMesh;
+    }
+
+    void Application::RecordMeshCopy(const MeshView &mesh, const GpuMesh &gpuMesh, PendingUpload &upload) {
+        vk::Buffer vertexStaging = CreateStagingBuffer(mesh.VertexData, upload);
+        vk::Buffer indexStaging = CreateStagingBuffer(mesh.IndexData, upload);
+
+        // Earlier frames have to be done reading the buffers before they are overwritten
+        upload.CommandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eVertexInput,
+                                             vk::PipelineStageFlagBits::eTransfer, {},
+                                             0, nullptr,
+                                             0, nullptr,
+                                             0, nullptr);
+
+        CopyBuffer(upload.CommandBuffer, vertexStaging, gpuMesh.VertexBuffer, mesh.VertexData.size_bytes());
+        CopyBuffer(upload.CommandBuffer, indexStaging, gpuMesh.IndexBuffer, mesh.IndexData.size_bytes());
+
+        // Makes the copies visible to every frame submitted after this upload
+        vk::MemoryBarrier barrier{
+                .srcAccessMask = vk::AccessFlagBits::eTransferWrite,
+                .dstAccessMask = vk::AccessFlagBits::eVertexAttributeRead | vk::AccessFlagBits::eIndexRead
+        };
+        upload.CommandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                                             vk::PipelineStageFlagBits::eVertexInput, {},
+                                             1, &barrier,
+                                             0, nullptr,
+                                             0, nullptr);
+    }
+
+    GpuTexture Application::CreateGpuTexture(const TextureView &texture, uint32_t baseMip) {
+        GpuTexture gpuTexture{
+                .Format = texture.Format,
+                .Width = texture.Width,
+                .Height = texture.Height,
+                .MipLevels = GetTextureMipLevels(texture),
+                .Layers = texture.Layers,
+                .BaseMip = baseMip
+        };
+
+        // Levels above the base are not resident and take no memory, the view starting at the base clamps sampling
+        CreateImage(std::max(texture.Width >> baseMip, 1u), std::max(texture.Height >> baseMip, 1u),
+                    gpuTexture.MipLevels - baseMip, texture.Layers, vk::SampleCountFlagBits::e1, texture.Format,
+                    vk::ImageTiling::eOptimal,
+                    vk::ImageUsageFlagBits::eTransferSrc | vk::ImageUsageFlagBits::eTransferDst |
+                    vk::ImageUsageFlagBits::eSampled,
+                    vk::MemoryPropertyFlagBits::eDeviceLocal, gpuTexture.Image, gpuTexture.ImageMemory);
+
+        // Always an array view, a single texture is sampled as layer zero
+        gpuTexture.ImageView = CreateImageView(gpuTexture.Image, vk::ImageViewType::e2DArray, texture.Format,
+                                               vk::ImageAspectFlagBits::eColor, gpuTexture.MipLevels - baseMip,
+                                               texture.Layers);
+
+        return gpuTexture;
+    }
+
+    GpuTexture Application::RecordTextureUpload(const TextureView &texture, uint32_t baseMip, PendingUpload &upload) {
+        GpuTexture gpuTexture = CreateGpuTexture(texture, baseMip);
+        RecordTextureCopy(texture, gpuTexture, vk::ImageLayout::eUndefined, upload);
+
+        return gpuTexture;
+    }
+
+    void Application::RecordTextureCopy(const TextureView &texture, const GpuTexture &gpuTexture,
+                                        vk::ImageLayout oldLayout, PendingUpload &upload) {
+        uint32_t residentLevels = gpuTexture.MipLevels - gpuTexture.BaseMip;
+        TransitionImageLayout(upload.CommandBuffer, gpuTexture.Image, texture.Format, oldLayout,
+                              vk::ImageLayout::eTransferDstOptimal, residentLevels);
+
+        // Only the stored levels are uploaded, the rest are blitted from the top one
+        if (texture.Mips.size() < gpuTexture.MipLevels) {
+            vk::Buffer stagingBuffer = CreateStagingBuffer(texture.Data, upload);
+            CopyBufferToImage(upload.CommandBuffer, stagingBuffer, gpuTexture.Image, texture.Mips, texture.Layers);
+            GenerateMipmaps(upload.CommandBuffer, gpuTexture.Image, texture.Format,
+                            static_cast<int32_t>(texture.Width), static_cast<int32_t>(texture.Height),
+                            gpuTexture.MipLevels, texture.Layers);
+            return;
+        }
+
+        std::vector<TextureMip> mips;
+        vk::Buffer stagingBuffer = StageTextureLevels(texture, gpuTexture.BaseMip, gpuTexture.MipLevels, mips,
+                                                      upload);
+        CopyBufferToImage(upload.CommandBuffer, stagingBuffer, gpuTexture.Image, mips, texture.Layers);
+        TransitionImageLayout(upload.CommandBuffer, gpuTexture.Image, texture.Format,
+                              vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal,
+                              residentLevels);
+    }
+
+    GpuTexture Application::RecordTextureRebase(const TextureView &texture, const GpuTexture &current,
+                                                uint32_t baseMip, PendingUpload &upload) {
+        GpuTexture gpuTexture = CreateGpuTexture(texture, baseMip);
+        uint32_t residentLevels = current.MipLevels - current.BaseMip;
+
+        TransitionImageLayout(upload.CommandBuffer, gpuTexture.Image, texture.Format, vk::ImageLayout::eUndefined,
+                              vk::ImageLayout::eTransferDstOptimal, gpuTexture.MipLevels - baseMip);
+        TransitionImageLayout(upload.CommandBuffer, current.Image, texture.Format,
+                              vk::ImageLayout::eShaderReadOnlyOptimal, vk::ImageLayout::eTransferSrcOptimal,
+                              residentLevels);
+
+        // Levels both images hold are copied on the GPU, only finer ones come from the source
+        std::vector<vk::ImageCopy> regions;
+        for (uint32_t level = std::max(baseMip, current.BaseMip); level < gpuTexture.MipLevels; level++) {
+            const TextureMip &mip = texture.Mips[level];
+            regions.push_back({
+                    .srcSubresource {
+                            .aspectMask = vk::ImageAspectFlagBits::eColor,
+                            .mipLevel = level - current.BaseMip,
+                            .baseArrayLayer = 0,
+                            .layerCount = texture.Layers
+                    },
+                    .srcOffset {0, 0, 0},
+                    .dstSubresource {
+                            .aspectMask = vk::ImageAspectFlagBits::eColor,
+                            .mipLevel = level - baseMip,
+                            .baseArrayLayer = 0,
+                            .layerCount = texture.Layers
+                    },
+                    .dstOffset {0, 0, 0},
+                    .extent {
+                            .width = mip.Width,
+                            .height = mip.Height,
+                            .depth = 1
+                    }
+            });
+        }
+
+        upload.CommandBuffer.copyImage(current.Image, vk::ImageLayout::eTransferSrcOptimal, gpuTexture.Image,
+                                       vk::ImageLayout::eTransferDstOptimal, static_cast<uint32_t>(regions.size()),
+                                       regions.data());
+
+        if (baseMip < current.BaseMip) {
+            std::vector<TextureMip> mips;
+            vk::Buffer stagingBuffer = StageTextureLevels(texture, baseMip, current.BaseMip, mips, upload);
+            CopyBufferToImage(upload.CommandBuffer, stagingBuffer, gpuTexture.Image, mips, texture.Layers);
+        }
+
+        // Frames recorded before the swap still sample the current image
+        TransitionImageLayout(upload.CommandBuffer, current.Image, texture.Format,
+                              vk::ImageLayout::eTransferSrcOptimal, vk::ImageLayout::eShaderReadOnlyOptimal,
+                              residentLevels);
+        TransitionImageLayout(upload.CommandBuffer, gpuTexture.Image, texture.Format,
+                              vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal,
+                              gpuTexture.MipLevels - baseMip);
+
+        return gpuTexture;
+    }
+
+    vk::Buffer Application::StageTextureLevels(const TextureView &texture, uint32_t firstLevel, uint32_t endLevel,
+                                               std::vector<TextureMip> &mips, PendingUpload &upload) {
+        // Consecutive levels are stored next to each other in either level order, so one range covers them
+        uint64_t begin = UINT64_MAX;
+        uint64_t end = 0;
+        for (uint32_t level = firstLevel; level < endLevel; level++) {
+            begin = std::min(begin, texture.Mips[level].Offset);
+            end = std::max(end, texture.Mips[level].Offset + texture.Mips[level].Size);
+        }
+
+        mips.clear();
+        for (uint32_t level = firstLevel; level < endLevel; level++) {
+            TextureMip mip = texture.Mips[level];
+            mip.Offset -= begin;
+            mips.push_back(mip);
+        }
+
+        return CreateStagingBuffer(texture.Data.subspan(begin, end - begin), upload);
+    }
+
+    void Application::SwapInMesh(const GpuMesh &gpuMesh, LoadedMesh &&mesh) {
+        GpuMesh previous = m_GpuMesh;
+        Retire([this, previous]() { DestroyMesh(previous); });
+
+        m_GpuMesh = gpuMesh;
+        SetMesh(std::move(mesh));
+    }
+
+    void Application::SetMesh(LoadedMesh &&mesh) {
+        VertexLayout previousLayout = m_Mesh.Layout;
+        m_LoadedMesh = std::move(mesh);
+        m_Mesh = m_LoadedMesh.View();
+
+        // The placeholder is built in the baked layout, so this only happens for meshes baked with other options
+        // Frames in flight still use the old pipelines, they are retired like replaced buffers
+        if (!(m_Mesh.Layout == previousLayout)) {
+            vk::PipelineLayout pipelineLayout = m_PipelineLayout;
+            vk::Pipeline graphicsPipeline = m_GraphicsPipeline;
+            vk::Pipeline wireframePipeline = m_WireframePipeline;
+            Retire([this, pipelineLayout, graphicsPipeline, wireframePipeline]() {
+                m_Device.destroyPipeline(graphicsPipeline);
+                m_Device.destroyPipeline(wireframePipeline);
+                m_Device.destroyPipelineLayout(pipelineLayout);
+            });
+
+            CreateGraphicsPipeline();
+        }
+    }
+
+    void Application::SwapInTexture(GpuTexture &target, const GpuTexture &texture) {
+        GpuTexture previous = target;
+        Retire([this, previous]() { DestroyTexture(previous); });
+
+        target = texture;
+        std::fill(m_DescriptorSetsDirty.begin(), m_DescriptorSetsDirty.end(), true);
+    }
+
+    void Application::Retire(std::function<void()> destroy) {
+        m_RetiredResources.push_back({m_FrameNumber, std::move(destroy)});
+    }
+
+    void Application::ReleaseRetiredResources(bool all) {
+        // Frames before the current one may still be executing, the fence of this frame slot covers older ones
+        std::erase_if(m_RetiredResources, [&](RetiredResource &resource) {
+            if (!all && resource.Frame + MAX_FRAMES_IN_FLIGHT > m_FrameNumber)
+                return false;
+
+            resource.Destroy();
+            return true;
+        });
+    }
+
+    void Application::DestroyMesh(const GpuMesh &mesh) {
+        m_Device.destroyBuffer(mesh.IndexBuffer);
+        m_Device.freeMemory(mesh.IndexBufferMemory);
+
+        m_Device.destroyBuffer(mesh.VertexBuffer);
+        m_Device.freeMemory(mesh.VertexBufferMemory);
+    }
+
+    void Application::DestroyTexture(const GpuTexture &texture) {
+        m_Device.destroyImageView(texture.ImageView);
+        m_Device.destroyImage(texture.Image);
+        m_Device.freeMemory(texture.ImageMemory);
+    }
+
+    void Application::CopyBufferToImage(vk::CommandBuffer commandBuffer, vk::Buffer buffer, vk::Image image,
+                                        std::span<const TextureMip> mips, uint32_t layers) {
+        // One region per stored mip level covering every layer, all uploaded by a single copy
+        std::vector<vk::BufferImageCopy> regions;
+        regions.reserve(mips.size());
+
+        for (uint32_t level = 0; level < mips.size(); level++) {
+            regions.push_back({
+                    .bufferOffset = mips[level].Offset,
+                    .bufferRowLength = 0,
+                    .bufferImageHeight = 0,
+                    .imageSubresource {
+                            .aspectMask = vk::ImageAspectFlagBits::eColor,
+                            .mipLevel = level,
+                            .baseArrayLayer = 0,
+                            .layerCount = layers
+                    },
+                    .imageOffset {0, 0, 0},
+                    .imageExtent {
+                            .width = mips[level].Width,
+                            .height = mips[level].Height,
+                            .depth = 1
+                    }
+            });
+        }
+
+        commandBuffer.copyBufferToImage(buffer, image, vk::ImageLayout::eTransferDstOptimal,
+                                        static_cast<uint32_t>(regions.size()), regions.data());
     }
 
     void
-    Application::CreateImage(uint32_t width, uint32_t height, uint32_t mipLevels, vk::SampleCountFlagBits numSamples,
-                             vk::Format format,
+    Application::CreateImage(uint32_t width, uint32_t height, uint32_t mipLevels, uint32_t arrayLayers,
+                             vk::SampleCountFlagBits numSamples, vk::Format format,
                              vk::ImageTiling tiling,
                              vk::ImageUsageFlags usage, vk::MemoryPropertyFlags properties, vk::Image &image,
                              vk::DeviceMemory &imageMemory) {
@@ -843,7 +1469,7 @@ namespace Haus {
                         .depth = 1
                 },
                 .mipLevels = mipLevels,
-                .arrayLayers = 1,
+                .arrayLayers = arrayLayers,
                 .samples = numSamples,
                 .tiling = tiling,
                 .usage = usage,
@@ -868,48 +1494,31 @@ namespace Haus {
         m_Device.bindImageMemory(image, imageMemory, 0);
     }
 
-    void Application::CreateTextureImage() {
-        stbi_set_flip_vertically_on_load(true);
-        int width, height, channels;
-        stbi_uc *pixels = stbi_load("assets/models/Moon/Textures/Diffuse_2K.png", &width, &height, &channels,
-                                    STBI_rgb_alpha);
-        m_MipLevels = static_cast<uint32_t>(std::floor(std::log2(std::max(width, height)))) + 1;
-        vk::DeviceSize imageSize = width * height * 4;
-
-        if (!pixels)
-            throw std::runtime_error("Failed to load texture image");
-
-        vk::Buffer stagingBuffer;
-        vk::DeviceMemory stagingBufferMemory;
-
-        CreateBuffer(imageSize, vk::BufferUsageFlagBits::eTransferSrc,
-                     vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
-                     stagingBuffer, stagingBufferMemory);
-
-        void *data = m_Device.mapMemory(stagingBufferMemory, 0, imageSize);
-        memcpy(data, pixels, static_cast<size_t>(imageSize));
-        m_Device.unmapMemory(stagingBufferMemory);
-
-        stbi_image_free(pixels);
-
-        CreateImage(width, height, m_MipLevels, vk::SampleCountFlagBits::e1, vk::Format::eR8G8B8A8Srgb,
-                    vk::ImageTiling::eOptimal,
-                    vk::ImageUsageFlagBits::eTransferSrc | vk::ImageUsageFlagBits::eTransferDst |
-                    vk::ImageUsageFlagBits::eSampled,
-                    vk::MemoryPropertyFlagBits::eDeviceLocal, m_TextureImage, m_TextureImageMemory);
+    void Application::CreatePlaceholderAssets() {
+        m_LoadedMesh.Imported = AssetLoader::CreatePlaceholderMesh(AssetCompiler::GetMeshOptions().Layout);
+        m_Mesh = m_LoadedMesh.View();
 
-        TransitionImageLayout(m_TextureImage, vk::Format::eR8G8B8A8Srgb, vk::ImageLayout::eUndefined,
-                              vk::ImageLayout::eTransferDstOptimal, m_MipLevels);
-        CopyBufferToImage(stagingBuffer, m_TextureImage, static_cast<uint32_t>(width), static_cast<uint32_t>(height));
+        TextureData texture = AssetLoader::CreatePlaceholderTexture();
+        TextureData normalMap = AssetLoader::CreatePlaceholderNormalMap();
 
-        GenerateMipmaps(m_TextureImage, width, height, m_MipLevels);
+        // Uploaded the same way as the real assets, waited on right away since the first frame needs them
+        PendingUpload upload = BeginUpload();
+        m_GpuMesh = RecordMeshUpload(m_Mesh, upload);
+        m_Texture = RecordTextureUpload(texture.View(), 0, upload);
+        m_NormalMap = RecordTextureUpload(normalMap.View(), 0, upload);
+        SubmitUpload(upload);
 
-        m_Device.destroyBuffer(stagingBuffer);
-        m_Device.freeMemory(stagingBufferMemory);
+        m_Device.waitForFences(1, &upload.Fence, VK_TRUE, UINT64_MAX);
+        FinishUpload(upload);
     }
 
-    void Application::GenerateMipmaps(vk::Image image, int32_t width, int32_t height, uint32_t mipLevels) {
-        vk::CommandBuffer commandBuffer = BeginSingleTimeCommands();
+    void Application::GenerateMipmaps(vk::CommandBuffer commandBuffer, vk::Image image, vk::Format format,
+                                      int32_t width, int32_t height, uint32_t mipLevels, uint32_t layers) {
+        vk::FormatProperties formatProperties =
+                m_VulkanContext->GetVulkanPhysicalDevice()->GetPhysicalDevice().getFormatProperties(format);
+        if (mipLevels > 1 &&
+            !(formatProperties.optimalTilingFeatures & vk::FormatFeatureFlagBits::eSampledImageFilterLinear))
+            throw std::runtime_error("Texture image format does not support linear blitting");
 
         vk::ImageMemoryBarrier barrier{};
         barrier.image = image;
@@ -919,7 +1528,7 @@ namespace Haus {
                 .aspectMask = vk::ImageAspectFlagBits::eColor,
                 .levelCount = 1,
                 .baseArrayLayer = 0,
-                .layerCount = 1,
+                .layerCount = layers,
         };
 
         int32_t mipWidth = width;
@@ -944,14 +1553,14 @@ namespace Haus {
                     .aspectMask = vk::ImageAspectFlagBits::eColor,
                     .mipLevel = i - 1,
                     .baseArrayLayer = 0,
-                    .layerCount = 1
+                    .layerCount = layers
             };
-            blit.dstOffsets = {{{{}, {mipWidth / 1 ? mipWidth / 2 : 1, mipHeight > 1 ? mipHeight / 2 : 1, 1}}}};
+            blit.dstOffsets = {{{{}, {mipWidth > 1 ? mipWidth / 2 : 1, mipHeight > 1 ? mipHeight / 2 : 1, 1}}}};
             blit.dstSubresource = {
                     .aspectMask = vk::ImageAspectFlagBits::eColor,
                     .mipLevel = i,
                     .baseArrayLayer = 0,
-                    .layerCount = 1
+                    .layerCount = layers
             };
 
             commandBuffer.blitImage(image, vk::ImageLayout::eTransferSrcOptimal,
@@ -986,22 +1595,20 @@ namespace Haus {
                                       0, nullptr,
                                       0, nullptr,
                                       1, &barrier);
-
-        EndSingleTimeCommands(commandBuffer);
     }
 
-    vk::ImageView Application::CreateImageView(vk::Image image, vk::Format format, vk::ImageAspectFlags aspectFlags,
-                                               uint32_t mipLevels) {
+    vk::ImageView Application::CreateImageView(vk::Image image, vk::ImageViewType viewType, vk::Format format,
+                                               vk::ImageAspectFlags aspectFlags, uint32_t mipLevels, uint32_t layers) {
         vk::ImageViewCreateInfo viewInfo{
                 .image = image,
-                .viewType = vk::ImageViewType::e2D,
+                .viewType = viewType,
                 .format = format,
                 .subresourceRange {
                         .aspectMask = aspectFlags,
                         .baseMipLevel = 0,
                         .levelCount = mipLevels,
                         .baseArrayLayer = 0,
-                        .layerCount = 1
+                        .layerCount = layers
                 }
         };
 
@@ -1012,11 +1619,6 @@ namespace Haus {
         return imageView;
     }
 
-    void Application::CreateTextureImageView() {
-        m_TextureImageView = CreateImageView(m_TextureImage, vk::Format::eR8G8B8A8Srgb, vk::ImageAspectFlagBits::eColor,
-                                             m_MipLevels);
-    }
-
     void Application::CreateTextureSampler() {
         vk::PhysicalDeviceProperties properties = m_VulkanContext->GetVulkanPhysicalDevice()->GetPhysicalDevice().getProperties();
 
@@ -1033,7 +1635,8 @@ namespace Haus {
                 .compareEnable = vk::False,
                 .compareOp = vk::CompareOp::eAlways,
                 .minLod = 0.0f,
-                .maxLod = static_cast<float>(m_MipLevels),
+                // Not clamped to a mip count, the sampler outlives the textures swapped in under it
+                .maxLod = vk::LodClampNone,
                 .borderColor = vk::BorderColor::eIntOpaqueBlack,
                 .unnormalizedCoordinates = vk::False,
         };
@@ -1042,21 +1645,20 @@ namespace Haus {
             throw std::runtime_error("Failed to create texture sampler");
     }
 
-    void Application::TransitionImageLayout(vk::Image image, vk::Format format, vk::ImageLayout oldLayout,
-                                            vk::ImageLayout newLayout, uint32_t mipLevels) {
-        vk::CommandBuffer commandBuffer = BeginSingleTimeCommands();
-
+    void Application::TransitionImageLayout(vk::CommandBuffer commandBuffer, vk::Image image, vk::Format format,
+                                            vk::ImageLayout oldLayout, vk::ImageLayout newLayout, uint32_t mipLevels) {
         vk::ImageMemoryBarrier barrier{
                 .oldLayout = oldLayout,
                 .newLayout = newLayout,
                 .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
                 .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
                 .image = image,
+                // Every layer, texture arrays move between layouts as a whole
                 .subresourceRange {
                         .baseMipLevel = 0,
                         .levelCount = mipLevels,
                         .baseArrayLayer = 0,
-                        .layerCount = 1
+                        .layerCount = vk::RemainingArrayLayers
                 },
         };
 
@@ -1080,6 +1682,29 @@ namespace Haus {
             barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
             barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
 
+            sourceStage = vk::PipelineStageFlagBits::eTransfer;
+            destinationStage = vk::PipelineStageFlagBits::eFragmentShader;
+        } else if (oldLayout == vk::ImageLayout::eShaderReadOnlyOptimal &&
+                   newLayout == vk::ImageLayout::eTransferDstOptimal) {
+            // Reloaded in place, frames submitted earlier are still sampling the old contents
+            barrier.srcAccessMask = vk::AccessFlagBits::eNone;
+            barrier.dstAccessMask = vk::AccessFlagBits::eTransferWrite;
+
+            sourceStage = vk::PipelineStageFlagBits::eFragmentShader;
+            destinationStage = vk::PipelineStageFlagBits::eTransfer;
+        } else if (oldLayout == vk::ImageLayout::eShaderReadOnlyOptimal &&
+                   newLayout == vk::ImageLayout::eTransferSrcOptimal) {
+            // Copied into a refined image while frames submitted earlier may still sample it
+            barrier.srcAccessMask = vk::AccessFlagBits::eNone;
+            barrier.dstAccessMask = vk::AccessFlagBits::eTransferRead;
+
+            sourceStage = vk::PipelineStageFlagBits::eFragmentShader;
+            destinationStage = vk::PipelineStageFlagBits::eTransfer;
+        } else if (oldLayout == vk::ImageLayout::eTransferSrcOptimal &&
+                   newLayout == vk::ImageLayout::eShaderReadOnlyOptimal) {
+            barrier.srcAccessMask = vk::AccessFlagBits::eNone;
+            barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
+
             sourceStage = vk::PipelineStageFlagBits::eTransfer;
             destinationStage = vk::PipelineStageFlagBits::eFragmentShader;
         } else if (oldLayout == vk::ImageLayout::eUndefined &&
@@ -1101,8 +1726,6 @@ namespace Haus {
                 0, nullptr,
                 1, &barrier
         );
-
-        EndSingleTimeCommands(commandBuffer);
     }
 
     uint32_t Application::FindMemoryType(uint32_t typeFilter, vk::MemoryPropertyFlags properties) {
@@ -1141,57 +1764,12 @@ namespace Haus {
         m_Device.bindBufferMemory(buffer, bufferMemory, 0);
     }
 
-    void Application::CopyBuffer(vk::Buffer srcBuffer, vk::Buffer dstBuffer, vk::DeviceSize size) {
-        vk::CommandBuffer commandBuffer = BeginSingleTimeCommands();
-
+    void Application::CopyBuffer(vk::CommandBuffer commandBuffer, vk::Buffer srcBuffer, vk::Buffer dstBuffer,
+                                 vk::DeviceSize size) {
         vk::BufferCopy copyRegion{
                 .size = size
         };
         commandBuffer.copyBuffer(srcBuffer, dstBuffer, 1, &copyRegion);
-
-        EndSingleTimeCommands(commandBuffer);
-    }
-
-    void Application::CreateVertexBuffer() {
-        vk::DeviceSize bufferSize = sizeof(vertices[0]) * vertices.size();
-
-        vk::Buffer stagingBuffer;
-        vk::DeviceMemory stagingBufferMemory;
-        CreateBuffer(bufferSize, vk::BufferUsageFlagBits::eTransferSrc,
-                     vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
-                     stagingBuffer, stagingBufferMemory);
-
-        void *data = m_Device.mapMemory(stagingBufferMemory, 0, bufferSize);
-        memcpy(data, vertices.data(), (size_t) bufferSize);
-        m_Device.unmapMemory(stagingBufferMemory);
-
-        CreateBuffer(bufferSize, vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eVertexBuffer,
-                     vk::MemoryPropertyFlagBits::eDeviceLocal, m_VertexBuffer, m_VertexBufferMemory);
-
-        CopyBuffer(stagingBuffer, m_VertexBuffer, bufferSize);
-        m_Device.destroyBuffer(stagingBuffer);
-        m_Device.freeMemory(stagingBufferMemory);
-    }
-
-    void Application::CreateIndexBuffer() {
-        vk::DeviceSize bufferSize = sizeof(indices[0]) * indices.size();
-
-        vk::Buffer stagingBuffer;
-        vk::DeviceMemory stagingBufferMemory;
-        CreateBuffer(bufferSize, vk::BufferUsageFlagBits::eTransferSrc,
-                     vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
-                     stagingBuffer, stagingBufferMemory);
-
-        void *data = m_Device.mapMemory(stagingBufferMemory, 0, bufferSize);
-        memcpy(data, indices.data(), (size_t) bufferSize);
-        m_Device.unmapMemory(stagingBufferMemory);
-
-        CreateBuffer(bufferSize, vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eIndexBuffer,
-                     vk::MemoryPropertyFlagBits::eDeviceLocal, m_IndexBuffer, m_IndexBufferMemory);
-
-        CopyBuffer(stagingBuffer, m_IndexBuffer, bufferSize);
-        m_Device.destroyBuffer(stagingBuffer);
-        m_Device.freeMemory(stagingBufferMemory);
     }
 
     void Application::CreateUniformBuffers() {
@@ -1218,7 +1796,7 @@ namespace Haus {
                 },
                 vk::DescriptorPoolSize{
                         .type = vk::DescriptorType::eCombinedImageSampler,
-                        .descriptorCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT)
+                        .descriptorCount = static_cast<uint32_t>(2 * MAX_FRAMES_IN_FLIGHT)
                 },
         };
 
@@ -1245,42 +1823,60 @@ namespace Haus {
         if (m_Device.allocateDescriptorSets(&allocateInfo, m_DescriptorSets.data()) != vk::Result::eSuccess)
             throw std::runtime_error("Failed to allocate descriptor sets");
 
-        for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
-            vk::DescriptorBufferInfo bufferInfo{
-                    .buffer = m_UniformBuffers[i],
-                    .offset = 0,
-                    .range = sizeof(UniformBufferObject)
-            };
+        m_DescriptorSetsDirty.assign(MAX_FRAMES_IN_FLIGHT, false);
+        for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+            UpdateDescriptorSet(i);
+    }
 
-            vk::DescriptorImageInfo imageInfo{
-                    .sampler = m_TextureSampler,
-                    .imageView = m_TextureImageView,
-                    .imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal
-            };
+    void Application::UpdateDescriptorSet(size_t frame) {
+        vk::DescriptorBufferInfo bufferInfo{
+                .buffer = m_UniformBuffers[frame],
+                .offset = 0,
+                .range = sizeof(UniformBufferObject)
+        };
 
-            std::array<vk::WriteDescriptorSet, 2> descriptorWrites{
-                    vk::WriteDescriptorSet{
-                            .dstSet = m_DescriptorSets[i],
-                            .dstBinding = 0,
-                            .dstArrayElement = 0,
-                            .descriptorCount = 1,
-                            .descriptorType = vk::DescriptorType::eUniformBuffer,
-                            .pBufferInfo = &bufferInfo
-                    },
-                    vk::WriteDescriptorSet{
-                            .dstSet = m_DescriptorSets[i],
-                            .dstBinding = 1,
-                            .dstArrayElement = 0,
-                            .descriptorCount = 1,
-                            .descriptorType = vk::DescriptorType::eCombinedImageSampler,
-                            .pImageInfo = &imageInfo
-                    },
-            };
+        vk::DescriptorImageInfo imageInfo{
+                .sampler = m_TextureSampler,
+                .imageView = m_Texture.ImageView,
+                .imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal
+        };
 
+        vk::DescriptorImageInfo normalMapInfo{
+                .sampler = m_TextureSampler,
+                .imageView = m_NormalMap.ImageView,
+                .imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal
+        };
 
-            m_Device.updateDescriptorSets(static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0,
-                                          nullptr);
-        }
+        std::array<vk::WriteDescriptorSet, 3> descriptorWrites{
+                vk::WriteDescriptorSet{
+                        .dstSet = m_DescriptorSets[frame],
+                        .dstBinding = 0,
+                        .dstArrayElement = 0,
+                        .descriptorCount = 1,
+                        .descriptorType = vk::DescriptorType::eUniformBuffer,
+                        .pBufferInfo = &bufferInfo
+                },
+                vk::WriteDescriptorSet{
+                        .dstSet = m_DescriptorSets[frame],
+                        .dstBinding = 1,
+                        .dstArrayElement = 0,
+                        .descriptorCount = 1,
+                        .descriptorType = vk::DescriptorType::eCombinedImageSampler,
+                        .pImageInfo = &imageInfo
+                },
+                vk::WriteDescriptorSet{
+                        .dstSet = m_DescriptorSets[frame],
+                        .dstBinding = 2,
+                        .dstArrayElement = 0,
+                        .descriptorCount = 1,
+                        .descriptorType = vk::DescriptorType::eCombinedImageSampler,
+                        .pImageInfo = &normalMapInfo
+                },
+        };
+
+        m_Device.updateDescriptorSets(static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0,
+                                      nullptr);
+        m_DescriptorSetsDirty[frame] = false;
     }
 
     void Application::CreateCommandBuffers() {
@@ -1369,35 +1965,106 @@ namespace Haus {
         commandBuffer.setViewport(0, 1, &viewport);
         commandBuffer.setScissor(0, 1, &scissor);
 
-        vk::Buffer vertexBuffers[] = {m_VertexBuffer};
-        vk::DeviceSize offsets[] = {0};
-        commandBuffer.bindVertexBuffers(0, 1, vertexBuffers, offsets);
-        commandBuffer.bindIndexBuffer(m_IndexBuffer, 0, vk::IndexType::eUint32);
+        // Every stream lives in the one vertex buffer, binding n starts at stream n
+        uint32_t streamCount = m_Mesh.Layout.GetStreamCount();
+        std::array<vk::Buffer, VertexLayout::MAX_STREAMS> vertexBuffers{};
+        std::array<vk::DeviceSize, VertexLayout::MAX_STREAMS> offsets{};
+        for (uint32_t stream = 0; stream < streamCount; stream++) {
+            vertexBuffers[stream] = m_GpuMesh.VertexBuffer;
+            offsets[stream] = m_Mesh.Layout.GetStreamOffset(stream, m_Mesh.VertexCount);
+        }
+        commandBuffer.bindVertexBuffers(0, streamCount, vertexBuffers.data(), offsets.data());
+        commandBuffer.bindIndexBuffer(m_GpuMesh.IndexBuffer, 0, m_Mesh.IndexType == IndexFormat::UInt16
+                                                                ? vk::IndexType::eUint16 : vk::IndexType::eUint32);
 
         commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, m_PipelineLayout, 0, 1,
                                          &m_DescriptorSets[m_CurrentFrame], 0, nullptr);
 
+        // The mesh has no material assignments, every instance is drawn with a material of its own. Materials only
+        // differ in their layers, so drawing another one needs no descriptor set bind.
+        const Material &left = m_Materials[0];
+        const Material &right = m_Materials[1 % m_Materials.size()];
         MyConstant constants[] = {
-                {glm::vec3(-0.7f, 0.0f, 0.0f)},
-                {glm::vec3(0.7f, 0.0f, 0.0f)},
+                {glm::vec3(-0.7f, 0.0f, 0.0f), m_Mesh.Quantization, left.ColorLayer, left.NormalMapLayer},
+                {glm::vec3(0.7f, 0.0f, 0.0f), m_Mesh.Quantization, right.ColorLayer, right.NormalMapLayer},
         };
 
+        m_TextureScreenSize = 0.0f;
+        if (m_TextureResident != 0)
+            m_TextureResidency.Touch(m_TextureResident, m_FrameNumber);
+        if (m_NormalMapResident != 0)
+            m_TextureResidency.Touch(m_NormalMapResident, m_FrameNumber);
+
         for (auto &constant: constants) {
             commandBuffer.pushConstants(m_PipelineLayout,
-                                        vk::ShaderStageFlagBits::eVertex,
+                                        vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment,
                                         0,
                                         sizeof(MyConstant),
                                         &constant);
-            commandBuffer.drawIndexed(static_cast<uint32_t>(indices.size()), 1, 0, 0, 0);
+
+            glm::mat4 transform = glm::translate(glm::mat4(1.0f), constant.Position) * m_ModelMatrix;
+            m_TextureScreenSize = std::max(m_TextureScreenSize,
+                                           GetProjectedDiameter(m_Mesh.Bounds, transform, m_CameraPosition,
+                                                                m_ProjectionScale,
+                                                                static_cast<float>(m_SwapchainExtent.height)));
+
+            uint32_t level = 0;
+            if (m_LodSelectionEnabled)
+                level = SelectLod(m_Mesh.Lods, m_Mesh.Bounds, transform, m_CameraPosition, m_ProjectionScale,
+                                  static_cast<float>(m_SwapchainExtent.height), m_LodPixelThreshold);
+            const MeshLod &lod = m_Mesh.Lods[level];
+
+            if (m_MeshletCullingEnabled && lod.MeshletCount > 0) {
+                DrawVisibleMeshlets(commandBuffer, transform, lod);
+                continue;
+            }
+
+            for (const MeshBatch &batch: m_Mesh.Batches.subspan(lod.FirstBatch, lod.BatchCount))
+                commandBuffer.drawIndexed(batch.IndexCount, 1, batch.FirstIndex, batch.VertexOffset, 0);
         }
 
         commandBuffer.endRenderPass();
         commandBuffer.end();
     }
 
+    void Application::DrawVisibleMeshlets(vk::CommandBuffer commandBuffer, const glm::mat4 &transform,
+                                          const MeshLod &lod) {
+        Frustum frustum = Frustum::FromMatrix(m_ViewProjection);
+
+        // Meshlets are contiguous index ranges, so neighbouring visible ones are merged into a single draw
+        MeshBatch draw{0, 0, 0};
+        for (const Meshlet &meshlet: m_Mesh.Meshlets.subspan(lod.FirstMeshlet, lod.MeshletCount)) {
+            if (!IsMeshletVisible(meshlet, transform, frustum, m_CameraPosition))
+                continue;
+
+            if (draw.IndexCount > 0 && draw.FirstIndex + draw.IndexCount == meshlet.FirstIndex &&
+                draw.VertexOffset == meshlet.VertexOffset) {
+                draw.IndexCount += meshlet.IndexCount;
+                continue;
+            }
+
+            if (draw.IndexCount > 0)
+                commandBuffer.drawIndexed(draw.IndexCount, 1, draw.FirstIndex, draw.VertexOffset, 0);
+
+            draw = {meshlet.FirstIndex, meshlet.IndexCount, meshlet.VertexOffset};
+        }
+
+        if (draw.IndexCount > 0)
+            commandBuffer.drawIndexed(draw.IndexCount, 1, draw.FirstIndex, draw.VertexOffset, 0);
+    }
+
     void Application::DrawFrame() {
         m_Device.waitForFences(1, &m_InFlightFences[m_CurrentFrame], VK_TRUE, UINT64_MAX);
 
+        // Frame boundary, nothing recorded for this frame slot is still executing
+        PollFileChanges();
+        m_FrameTasks.Drain();
+        PollAssetTasks();
+        UpdateTextureStreaming();
+        ReleaseRetiredResources(false);
+        if (m_DescriptorSetsDirty[m_CurrentFrame])
+            UpdateDescriptorSet(m_CurrentFrame);
+
         // Take a break from this, since it works and sometimes not and I have no idea what to do now so time to do some other stuff in Vulkan :)
         if (m_MsaaChanged[m_CurrentFrame]) {
             std::cout << "Changed MSAA to " << to_string(m_MsaaSamples) << "\n";
@@ -1481,6 +2148,7 @@ namespace Haus {
             throw std::runtime_error("Failed to present swap chain image!");
 
         m_CurrentFrame = (m_CurrentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+        m_FrameNumber++;
     }
 
 
@@ -1493,10 +2161,11 @@ namespace Haus {
         glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, 0.0f)) *
                           glm::rotate(glm::mat4(1.0f), time * glm::radians(0.0f), glm::vec3(0.0f, 1.0f, 0.0f))
                           * glm::scale(glm::mat4(1.0f), glm::vec3(0.3f, 0.3f, 0.3f));
+        glm::vec3 cameraPosition(0.0f, 0.0f, 3.0f);
         UniformBufferObject uniformBufferObject{
                 .model = model,
-                .view = glm::lookAt(glm::vec3(0.0f, 0.0f, 3.0f),
-                                    glm::vec3(0.0f, 0.0f, 3.0f) + glm::vec3(0.0f, 0.0f, -3.0f),
+                .view = glm::lookAt(cameraPosition,
+                                    cameraPosition + glm::vec3(0.0f, 0.0f, -3.0f),
                                     glm::vec3(0.0f, 1.0f, 0.0f)),
                 .projection = glm::perspective(glm::radians(45.0f),
                                                (float) m_SwapchainExtent.width / (float) m_SwapchainExtent.height, 0.1f,
@@ -1505,10 +2174,18 @@ namespace Haus {
 
         uniformBufferObject.normalInverse = glm::inverse(uniformBufferObject.model);
 
+        m_ModelMatrix = uniformBufferObject.model;
+        m_ViewProjection = uniformBufferObject.projection * uniformBufferObject.view;
+        m_ProjectionScale = uniformBufferObject.projection[1][1];
+        m_CameraPosition = cameraPosition;
+
         memcpy(m_UniformBuffersMapped[currentImage], &uniformBufferObject, sizeof(uniformBufferObject));
     }
 
     void Application::CleanupVulkan() {
+        FinishAssetTasks();
+        ReleaseRetiredResources(true);
+
         CleanupSwapchain();
 
         for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
@@ -1520,15 +2197,9 @@ namespace Haus {
         m_Device.destroyDescriptorSetLayout(m_DescriptorSetLayout);
 
         m_Device.destroySampler(m_TextureSampler);
-        m_Device.destroyImageView(m_TextureImageView);
-        m_Device.destroyImage(m_TextureImage);
-        m_Device.freeMemory(m_TextureImageMemory);
-
-        m_Device.destroyBuffer(m_IndexBuffer);
-        m_Device.freeMemory(m_IndexBufferMemory);
-
-        m_Device.destroyBuffer(m_VertexBuffer);
-        m_Device.freeMemory(m_VertexBufferMemory);
+        DestroyTexture(m_Texture);
+        DestroyTexture(m_NormalMap);
+        DestroyMesh(m_GpuMesh);
 
         for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
             m_Device.destroySemaphore(m_ImageAvailableSemaphores[i]);
@@ -7,78 +7,22 @@
 #include "glm/vec4.hpp"
 #include "Window.h"
 
-#define GLM_FORCE_RADIANS
-#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include "Assets/Culling.h"
+#include "Assets/Mesh.h"
 
-#include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
-#define GLM_ENABLE_EXPERIMENTAL
-
-#include <glm/gtx/hash.hpp>
+#include "Assets/AssetCompiler.h"
+#include "Assets/AssetLoader.h"
+#include "Assets/FileWatcher.h"
+#include "Assets/Task.h"
+#include "Assets/TexturePacker.h"
+#include "Assets/TextureResidency.h"
 #include "Vulkan/VulkanContext.h"
-struct Vertex {
-    glm::vec3 Position;
-    glm::vec3 Color;
-    glm::vec2 TextureCoord;
-    glm::vec3 Normal;
-
-    static vk::VertexInputBindingDescription GetBindingDescription() {
-        vk::VertexInputBindingDescription bindingDescription{
-                .binding = 0,
-                .stride = sizeof(Vertex),
-                .inputRate = vk::VertexInputRate::eVertex
-        };
-
-        return bindingDescription;
-    }
-
-    static std::array<vk::VertexInputAttributeDescription, 4> GetAttributeDescriptions() {
-        std::array<vk::VertexInputAttributeDescription, 4> attributeDescription{
-                vk::VertexInputAttributeDescription{
-                        .location = 0,
-                        .binding = 0,
-                        .format = vk::Format::eR32G32B32Sfloat,
-                        .offset = offsetof(Vertex, Position)
-                },
-                vk::VertexInputAttributeDescription{
-                        .location = 1,
-                        .binding = 0,
-                        .format = vk::Format::eR32G32B32Sfloat,
-                        .offset = offsetof(Vertex, Color)
-                },
-                vk::VertexInputAttributeDescription{
-                        .location = 2,
-                        .binding = 0,
-                        .format = vk::Format::eR32G32Sfloat,
-                        .offset = offsetof(Vertex, TextureCoord)
-                },
-                vk::VertexInputAttributeDescription{
-                        .location = 3,
-                        .binding = 0,
-                        .format = vk::Format::eR32G32B32Sfloat,
-                        .offset = offsetof(Vertex, Normal)
-                }
-        };
-
-        return attributeDescription;
-    }
-
-    bool operator==(const Vertex &other) const {
-        return Position == other.Position && Color == other.Color && TextureCoord == other.TextureCoord;
-    }
-};
-
-namespace std {
-    template<>
-    struct hash<Vertex> {
-        size_t operator()(Vertex const &vertex) const {
-            return ((hash<glm::vec3>()(vertex.Position) ^
-                     (hash<glm::vec3>()(vertex.Color) << 1)) >> 1) ^
-                   (hash<glm::vec2>()(vertex.TextureCoord) << 1);
-        }
-    };
-}
+
+#include <functional>
+#include <future>
+#include <memory>
 
 namespace Haus {
 
@@ -86,6 +30,8 @@ namespace Haus {
         std::string Name;
         int Width;
         int Height;
+        // Device memory streamed textures may keep resident, least recently used ones drop levels beyond it
+        uint64_t TextureBudget = 256ull * 1024 * 1024;
     };
 
     struct SwapChainSupportDetails {
@@ -94,6 +40,61 @@ namespace Haus {
         std::vector<vk::PresentModeKHR> PresentModes;
     };
 
+    struct GpuMesh {
+        // Allocated sizes, a reloaded mesh that fits is copied into the same buffers
+        vk::DeviceSize VertexBufferSize = 0;
+        vk::DeviceSize IndexBufferSize = 0;
+        vk::Buffer VertexBuffer;
+        vk::DeviceMemory VertexBufferMemory;
+        vk::Buffer IndexBuffer;
+        vk::DeviceMemory IndexBufferMemory;
+    };
+
+    struct GpuTexture {
+        vk::Format Format = vk::Format::eUndefined;
+        uint32_t Width = 0;
+        uint32_t Height = 0;
+        uint32_t MipLevels = 1;
+        uint32_t Layers = 1;
+        // Width, Height and MipLevels describe the full texture, the image and view only hold the levels from here on
+        uint32_t BaseMip = 0;
+        vk::Image Image;
+        vk::ImageView ImageView;
+        vk::DeviceMemory ImageMemory;
+    };
+
+    // Copy recorded on the graphics queue, its staging buffers are freed once the fence has signalled
+    struct PendingUpload {
+        vk::CommandBuffer CommandBuffer;
+        vk::Fence Fence;
+        std::vector<vk::Buffer> StagingBuffers;
+        std::vector<vk::DeviceMemory> StagingBuffersMemory;
+    };
+
+    // Source shown by the renderer, every reload bumps the generation so loads it superseded are dropped
+    struct AssetSlot {
+        std::filesystem::path Source;
+        uint64_t Generation = 0;
+    };
+
+    // Textures of one kind, one source per material, packed into a single array image
+    struct TextureArraySlot {
+        std::vector<std::filesystem::path> Sources;
+        uint64_t Generation = 0;
+    };
+
+    // Layers of the material's textures in the bound arrays, pushed with every draw
+    struct Material {
+        uint32_t ColorLayer = 0;
+        uint32_t NormalMapLayer = 0;
+    };
+
+    // Resource replaced during a frame, destroyed once no frame in flight can still reference it
+    struct RetiredResource {
+        uint64_t Frame;
+        std::function<void()> Destroy;
+    };
+
     class Application {
     public:
         explicit Application(ApplicationSpecification &specification);
@@ -130,15 +131,17 @@ namespace Haus {
 
         uint32_t m_MinImageCount;
 
-        vk::ImageView
-        CreateImageView(vk::Image image, vk::Format format, vk::ImageAspectFlags aspectFlags, uint32_t mipLevels);
+        vk::ImageView CreateImageView(vk::Image image, vk::ImageViewType viewType, vk::Format format,
+                                      vk::ImageAspectFlags aspectFlags, uint32_t mipLevels, uint32_t layers);
 
         SwapChainSupportDetails QuerySwapChainSupport(vk::PhysicalDevice device);
 
-        vk::ShaderModule CreateShaderModule(const std::vector<char> &code);
+        vk::ShaderModule CreateShaderModule(const std::filesystem::path &path);
 
         void RecordCommandBuffer(vk::CommandBuffer commandBuffer, uint32_t imageIndex);
 
+        void DrawVisibleMeshlets(vk::CommandBuffer commandBuffer, const glm::mat4 &transform, const MeshLod &lod);
+
         void DrawFrame();
 
         void UpdateUniformBuffer(uint32_t currentImage);
@@ -148,26 +151,119 @@ namespace Haus {
         void CreateBuffer(vk::DeviceSize size, vk::BufferUsageFlags usage, vk::MemoryPropertyFlags properties,
                           vk::Buffer &buffer, vk::DeviceMemory &bufferMemory);
 
-        void CopyBuffer(vk::Buffer srcBuffer, vk::Buffer dstBuffer, vk::DeviceSize size);
+        void CopyBuffer(vk::CommandBuffer commandBuffer, vk::Buffer srcBuffer, vk::Buffer dstBuffer,
+                        vk::DeviceSize size);
 
         vk::CommandBuffer BeginSingleTimeCommands();
 
         void EndSingleTimeCommands(vk::CommandBuffer commandBuffer);
 
-        void LoadModel();
+        void StartAssetLoads();
+
+        // Reloads follow a loose baked file changing, which the archive opened at startup does not see
+        const AssetArchive *GetAssetArchive(uint64_t generation) const;
+
+        Task<> LoadMeshAsync(std::filesystem::path source, uint64_t generation);
+
+        Task<> LoadTextureAsync(std::vector<std::filesystem::path> sources, uint64_t generation);
+
+        // Uploaded whole, normal maps are small once block compressed and are not streamed
+        Task<> LoadNormalMapAsync(std::vector<std::filesystem::path> sources, uint64_t generation);
+
+        /* Loads every distinct source on the pool and packs them into one array, layers receives the layer of each
+           source and repeated sources share one. A single distinct source is returned as loaded, so a mapped cache
+           entry stays mapped for streaming. */
+        LoadedTexture LoadTextureArray(std::span<const std::filesystem::path> sources,
+                                       const TextureImportOptions &options, const AssetArchive *archive,
+                                       std::vector<uint32_t> &layers);
+
+        // Reloads the assets whose source, or cache entry when the source is not shipped, changed on disk
+        void PollFileChanges();
+
+        // Reports finished load tasks, a failed load keeps its placeholder
+        void PollAssetTasks();
+
+        void FinishAssetTasks();
+
+        PendingUpload BeginUpload();
+
+        void SubmitUpload(PendingUpload &upload);
 
-        void CopyBufferToImage(vk::Buffer buffer, vk::Image image, uint32_t width, uint32_t height);
+        // Suspends on the frame queue until the fence has signalled, then frees the upload
+        Task<> WaitForUpload(PendingUpload &upload);
 
-        void CreateImage(uint32_t width, uint32_t height, uint32_t mipLevels, vk::SampleCountFlagBits numSamples,
+        void FinishUpload(PendingUpload &upload);
+
+        vk::Buffer CreateStagingBuffer(std::span<const std::byte> data, PendingUpload &upload);
+
+        GpuMesh RecordMeshUpload(const MeshView &mesh, PendingUpload &upload);
+
+        // Copies into buffers that may still be read by frames submitted before the upload
+        void RecordMeshCopy(const MeshView &mesh, const GpuMesh &gpuMesh, PendingUpload &upload);
+
+        // Image and view for the levels of texture from baseMip on, their contents are left undefined
+        GpuTexture CreateGpuTexture(const TextureView &texture, uint32_t baseMip);
+
+        GpuTexture RecordTextureUpload(const TextureView &texture, uint32_t baseMip, PendingUpload &upload);
+
+        void RecordTextureCopy(const TextureView &texture, const GpuTexture &gpuTexture, vk::ImageLayout oldLayout,
+                               PendingUpload &upload);
+
+        // New image holding the levels of current from baseMip on, levels both hold are copied on the GPU
+        GpuTexture RecordTextureRebase(const TextureView &texture, const GpuTexture &current, uint32_t baseMip,
+                                       PendingUpload &upload);
+
+        // Stages levels [firstLevel, endLevel), mips receives their regions relative to the returned buffer
+        vk::Buffer StageTextureLevels(const TextureView &texture, uint32_t firstLevel, uint32_t endLevel,
+                                      std::vector<TextureMip> &mips, PendingUpload &upload);
+
+        // Finest level uploaded with a texture, the others are streamed in once the texture is large enough on screen
+        uint32_t GetTextureTailMip(const TextureView &texture) const;
+
+        uint32_t GetWantedTextureMip() const;
+
+        /* Applies evictions when over the texture budget, then starts streaming the next finer level when the
+           texture is drawn larger than its resident levels allow and the level fits */
+        void UpdateTextureStreaming();
+
+        void RebaseTexture(const TextureEviction &rebase);
+
+        // Streams levels in, or drops them, by swapping in an image that starts at baseMip
+        Task<> StreamTextureAsync(uint64_t generation, uint32_t baseMip);
+
+        // Replaces the CPU side of the mesh, frames recorded from now on use the new ranges and layout
+        void SetMesh(LoadedMesh &&mesh);
+
+        void SwapInMesh(const GpuMesh &gpuMesh, LoadedMesh &&mesh);
+
+        // Retires what target holds, frames recorded once the descriptor sets are rewritten sample the new texture
+        void SwapInTexture(GpuTexture &target, const GpuTexture &texture);
+
+        void Retire(std::function<void()> destroy);
+
+        void ReleaseRetiredResources(bool all);
+
+        void DestroyMesh(const GpuMesh &mesh);
+
+        void DestroyTexture(const GpuTexture &texture);
+
+        void UpdateDescriptorSet(size_t frame);
+
+        void CopyBufferToImage(vk::CommandBuffer commandBuffer, vk::Buffer buffer, vk::Image image,
+                               std::span<const TextureMip> mips, uint32_t layers);
+
+        void CreateImage(uint32_t width, uint32_t height, uint32_t mipLevels, uint32_t arrayLayers,
+                         vk::SampleCountFlagBits numSamples,
                          vk::Format format, vk::ImageTiling tiling,
                          vk::ImageUsageFlags usage, vk::MemoryPropertyFlags properties, vk::Image &image,
                          vk::DeviceMemory &imageMemory);
 
-        void
-        TransitionImageLayout(vk::Image image, vk::Format format, vk::ImageLayout oldLayout, vk::ImageLayout newLayout,
-                              uint32_t mipLevels);
+        void TransitionImageLayout(vk::CommandBuffer commandBuffer, vk::Image image, vk::Format format,
+                                   vk::ImageLayout oldLayout, vk::ImageLayout newLayout, uint32_t mipLevels);
 
-        void GenerateMipmaps(vk::Image image, int32_t width, int32_t height, uint32_t mipLevels);
+        // Blits the chain from the first level, textures loaded at runtime get their mips on the CPU instead
+        void GenerateMipmaps(vk::CommandBuffer commandBuffer, vk::Image image, vk::Format format, int32_t width,
+                             int32_t height, uint32_t mipLevels, uint32_t layers);
 
         void CleanupSwapchain();
 
@@ -201,16 +297,10 @@ namespace Haus {
 
         void CreateDepthResources();
 
-        void CreateTextureImage();
-
-        void CreateTextureImageView();
+        void CreatePlaceholderAssets();
 
         void CreateTextureSampler();
 
-        void CreateVertexBuffer();
-
-        void CreateIndexBuffer();
-
         void CreateUniformBuffers();
 
         void CreateDescriptorPool();
@@ -226,6 +316,10 @@ namespace Haus {
         vk::SampleCountFlagBits GetMaxUsableSampleCount();
 
         bool m_WireframeEnabled = false;
+        bool m_MeshletCullingEnabled = true;
+        bool m_LodSelectionEnabled = true;
+        // Largest simplification error, in pixels, a level of detail may show on screen
+        float m_LodPixelThreshold = 1.0f;
 
         VulkanContext* m_VulkanContext{};
         vk::SurfaceKHR m_Surface;
@@ -254,28 +348,64 @@ namespace Haus {
         std::vector<vk::Fence> m_InFlightFences;
 
 
-        std::vector<Vertex> vertices;
-        std::vector<uint32_t> indices;
-        vk::Buffer m_VertexBuffer;
-        vk::DeviceMemory m_VertexBufferMemory;
-
-        vk::Buffer m_IndexBuffer;
-        vk::DeviceMemory m_IndexBufferMemory;
-
+        // Placeholders are drawn until the real assets have been decoded on the pool and uploaded
+        ThreadPool m_ThreadPool;
+        // Resumed at the start of every frame, once the frame slot's fence has been waited on
+        TaskQueue m_FrameTasks;
+        CancellationToken m_AssetCancellation;
+        std::vector<std::future<void>> m_AssetTasks;
+        std::vector<RetiredResource> m_RetiredResources;
+        uint64_t m_FrameNumber = 0;
+
+        // Polled at the start of every frame, absent when there is no asset directory to watch
+        std::unique_ptr<FileWatcher> m_FileWatcher;
+        // Baked assets packed by haus-assetc, declared before the loaded assets that may point into its mapping
+        std::unique_ptr<AssetArchive> m_AssetArchive;
+        AssetSlot m_MeshAsset;
+        TextureArraySlot m_TextureAsset;
+        TextureArraySlot m_NormalMapAsset;
+        // Indexed like the sources of the texture slots
+        std::vector<Material> m_Materials;
+
+        MeshView m_Mesh;
+        LoadedMesh m_LoadedMesh;
+        GpuMesh m_GpuMesh;
+
+        // Transforms of the current frame, kept on the CPU for meshlet culling and level of detail selection
+        glm::mat4 m_ModelMatrix{1.0f};
+        glm::mat4 m_ViewProjection{1.0f};
+        float m_ProjectionScale = 1.0f;
+        glm::vec3 m_CameraPosition{0.0f};
         std::vector<vk::Buffer> m_UniformBuffers;
         std::vector<vk::DeviceMemory> m_UniformBuffersMemory;
         std::vector<void *> m_UniformBuffersMapped;
 
         vk::DescriptorPool m_DescriptorPool;
         std::vector<vk::DescriptorSet> m_DescriptorSets;
+        // Sets still pointing at a replaced texture, rewritten once their frame is no longer in flight
+        std::vector<bool> m_DescriptorSetsDirty;
 
         vk::SampleCountFlagBits m_MsaaSamples = vk::SampleCountFlagBits::e1;
+        // Set before the first asset load, textures are imported and kept uncompressed without it
+        bool m_BlockCompression = false;
 
-        uint32_t m_MipLevels;
-        vk::Image m_TextureImage;
-        vk::ImageView m_TextureImageView;
+        // Source of m_Texture, kept mapped so finer levels can be streamed in later
+        LoadedTexture m_LoadedTexture;
+        GpuTexture m_Texture;
         vk::Sampler m_TextureSampler;
-        vk::DeviceMemory m_TextureImageMemory;
+        const uint32_t TEXTURE_TAIL_SIZE = 64;
+        // maxImageArrayLayers every device supports
+        const uint32_t MAX_TEXTURE_LAYERS = 256;
+        // Largest on screen diameter, in pixels, of the meshes drawn with the texture during the last recorded frame
+        float m_TextureScreenSize = 0.0f;
+        bool m_TextureStreaming = false;
+        TextureResidency m_TextureResidency;
+        // Residency entry of m_Texture, zero while the placeholder is shown
+        uint32_t m_TextureResident = 0;
+        // Tangent space normals as BC5, or RG8 when not baked, z is rebuilt in the fragment shader
+        GpuTexture m_NormalMap;
+        // Uploaded whole, the entry counts every level against the budget and never gives any up
+        uint32_t m_NormalMapResident = 0;
 
         vk::Image m_ColorImage;
         vk::ImageView m_ColorImageView;
@@ -0,0 +1,206 @@
+#include "AssetArchive.h"
+#include "CacheFile.h"
+#include "Hash.h"
+#include "Lz4.h"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+
+namespace Haus {
+    namespace {
+        constexpr char MAGIC[8] = {'H', 'A', 'U', 'S', 'P', 'A', 'K', '\0'};
+
+        struct ArchiveHeader {
+            char Magic[8];
+            uint32_t Version;
+            uint32_t EntryCount;
+            uint64_t IndexOffset;
+            uint64_t NamesOffset;
+            uint64_t NamesSize;
+        };
+
+        struct PackedFile {
+            std::string Name;
+            MappedFile File;
+            uint64_t ContentHash = 0;
+            // Empty when the entry is stored as is
+            std::vector<std::byte> Compressed;
+        };
+
+        // Compressed entries have to be decoded on every load, a few percent off is not worth that
+        bool IsWorthCompressing(size_t size, size_t compressedSize) {
+            return compressedSize <= size - size / 8;
+        }
+    }
+
+    std::filesystem::path AssetArchive::GetArchivePath(const std::filesystem::path &directory) {
+        std::filesystem::path path = directory.lexically_normal();
+        if (!path.has_filename())
+            path = path.parent_path();
+
+        path += ".hpak";
+        return path;
+    }
+
+    AssetArchive::AssetArchive(const std::filesystem::path &path) : m_File(path, MappedFileAccess::Random) {
+        const std::byte *data = m_File.GetData();
+        size_t size = m_File.GetSize();
+
+        ArchiveHeader header{};
+        if (size < sizeof(header))
+            throw std::runtime_error("AssetArchive: " + path.string() + " is too small");
+
+        memcpy(&header, data, sizeof(header));
+        if (memcmp(header.Magic, MAGIC, sizeof(MAGIC)) != 0 || header.Version != VERSION)
+            throw std::runtime_error("AssetArchive: " + path.string() + " is not a supported archive");
+
+        uint64_t indexBytes = static_cast<uint64_t>(header.EntryCount) * sizeof(ArchiveEntry);
+        if (header.IndexOffset % alignof(ArchiveEntry) != 0 ||
+            !CacheFile::InBounds(header.IndexOffset, indexBytes, size) ||
+            !CacheFile::InBounds(header.NamesOffset, header.NamesSize, size))
+            throw std::runtime_error("AssetArchive: " + path.string() + " has a corrupt index");
+
+        m_Entries = {reinterpret_cast<const ArchiveEntry *>(data + header.IndexOffset), header.EntryCount};
+        m_Names = {reinterpret_cast<const char *>(data + header.NamesOffset), header.NamesSize};
+
+        // Checked once here, lookups and reads trust the index afterwards
+        for (const ArchiveEntry &entry: m_Entries) {
+            bool compressed = entry.Compression == ArchiveCompression::Lz4;
+            if (!CacheFile::InBounds(entry.NameOffset, entry.NameLength, m_Names.size()) ||
+                !CacheFile::InBounds(entry.Offset, entry.StoredSize, size) ||
+                (entry.Compression != ArchiveCompression::None && !compressed) ||
+                (!compressed && entry.StoredSize != entry.Size))
+                throw std::runtime_error("AssetArchive: " + path.string() + " has a corrupt index");
+        }
+
+        if (!std::ranges::is_sorted(m_Entries, {}, [&](const ArchiveEntry &entry) { return GetName(entry); }))
+            throw std::runtime_error("AssetArchive: " + path.string() + " has an unsorted index");
+    }
+
+    const ArchiveEntry *AssetArchive::Find(std::string_view name) const {
+        auto entry = std::ranges::lower_bound(m_Entries, name, {}, [&](const ArchiveEntry &candidate) {
+            return GetName(candidate);
+        });
+
+        if (entry == m_Entries.end() || GetName(*entry) != name)
+            return nullptr;
+
+        return &*entry;
+    }
+
+    std::string_view AssetArchive::GetName(const ArchiveEntry &entry) const {
+        return m_Names.substr(entry.NameOffset, entry.NameLength);
+    }
+
+    std::optional<std::span<const std::byte>> AssetArchive::Read(const ArchiveEntry &entry,
+                                                                 std::vector<std::byte> &storage) const {
+        std::span<const std::byte> stored = m_File.GetSpan().subspan(entry.Offset, entry.StoredSize);
+        // The archive is mapped for random access, the entry itself is read as a whole
+        m_File.Advise(stored, MappedFileAccess::WillNeed);
+
+        if (entry.Compression == ArchiveCompression::None)
+            return stored;
+
+        storage.resize(entry.Size);
+        if (!Lz4::Decompress(stored, storage) || Hash64(storage) != entry.ContentHash)
+            return std::nullopt;
+
+        return std::span<const std::byte>(storage);
+    }
+
+    uint32_t AssetArchive::Pack(const std::filesystem::path &directory, const std::filesystem::path &archivePath,
+                                ThreadPool *pool) {
+        if (!std::filesystem::is_directory(directory))
+            throw std::runtime_error("AssetArchive: " + directory.string() + " is not a directory");
+
+        std::filesystem::path root = (std::filesystem::absolute(directory).lexically_normal() / "..").lexically_normal();
+
+        std::vector<PackedFile> files;
+        for (const auto &entry: std::filesystem::recursive_directory_iterator(directory)) {
+            if (!entry.is_regular_file() || entry.path().extension() == ".tmp")
+                continue;
+
+            std::filesystem::path path = std::filesystem::absolute(entry.path()).lexically_normal();
+            files.push_back({std::filesystem::relative(path, root).generic_string(), MappedFile(path)});
+        }
+
+        std::ranges::sort(files, {}, &PackedFile::Name);
+        if (files.size() > UINT32_MAX)
+            throw std::runtime_error("AssetArchive: Too many files in " + directory.string());
+
+        ParallelFor(pool, files.size(), 1, [&](size_t begin, size_t end) {
+            for (PackedFile &file: std::span(files).subspan(begin, end - begin)) {
+                std::span<const std::byte> bytes = file.File.GetSpan();
+                file.ContentHash = Hash64(bytes);
+
+                std::vector<std::byte> compressed = Lz4::Compress(bytes);
+                if (IsWorthCompressing(bytes.size(), compressed.size()))
+                    file.Compressed = std::move(compressed);
+            }
+        });
+
+        ArchiveHeader header{
+                .Version = VERSION,
+                .EntryCount = static_cast<uint32_t>(files.size())
+        };
+        memcpy(header.Magic, MAGIC, sizeof(MAGIC));
+
+        std::string names;
+        std::vector<ArchiveEntry> entries(files.size());
+        for (size_t i = 0; i < files.size(); i++) {
+            entries[i].NameOffset = static_cast<uint32_t>(names.size());
+            entries[i].NameLength = static_cast<uint32_t>(files[i].Name.size());
+            names += files[i].Name;
+        }
+
+        header.IndexOffset = CacheFile::AlignUp(sizeof(header));
+        header.NamesOffset = header.IndexOffset + entries.size() * sizeof(ArchiveEntry);
+        header.NamesSize = names.size();
+
+        // Entries are aligned like the sections of the caches they hold, so those stay usable in place
+        std::map<std::pair<uint64_t, uint64_t>, const ArchiveEntry *> written;
+        std::vector<std::span<const std::byte>> sections(files.size());
+        uint64_t offset = CacheFile::AlignUp(header.NamesOffset + header.NamesSize);
+        for (size_t i = 0; i < files.size(); i++) {
+            const PackedFile &file = files[i];
+            ArchiveEntry &entry = entries[i];
+            entry.Size = file.File.GetSize();
+            entry.ContentHash = file.ContentHash;
+            if (entry.Size == 0)
+                continue;
+
+            auto [duplicate, inserted] = written.try_emplace({file.ContentHash, entry.Size}, &entry);
+            if (!inserted) {
+                entry.Offset = duplicate->second->Offset;
+                entry.StoredSize = duplicate->second->StoredSize;
+                entry.Compression = duplicate->second->Compression;
+                continue;
+            }
+
+            bool compressed = !file.Compressed.empty();
+            sections[i] = compressed ? std::span<const std::byte>(file.Compressed) : file.File.GetSpan();
+            entry.Offset = offset;
+            entry.StoredSize = sections[i].size();
+            entry.Compression = compressed ? ArchiveCompression::Lz4 : ArchiveCompression::None;
+            offset = CacheFile::AlignUp(offset + entry.StoredSize);
+        }
+
+        bool stored = CacheFile::Write(archivePath, [&](std::ofstream &file) {
+            CacheFile::WriteSection(file, 0, std::as_bytes(std::span(&header, 1)));
+            CacheFile::WriteSection(file, header.IndexOffset, std::as_bytes(std::span(entries)));
+            CacheFile::WriteSection(file, header.NamesOffset, std::as_bytes(std::span(names)));
+
+            for (size_t i = 0; i < files.size(); i++) {
+                if (!sections[i].empty())
+                    CacheFile::WriteSection(file, entries[i].Offset, sections[i]);
+            }
+        });
+
+        if (!stored)
+            throw std::runtime_error("AssetArchive: Failed to write " + archivePath.string());
+
+        return header.EntryCount;
+    }
+} // Haus
@@ -0,0 +1,73 @@
+#ifndef HAUS_ASSETARCHIVE_H
+#define HAUS_ASSETARCHIVE_H
+
+#include "MappedFile.h"
+#include "ThreadPool.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace Haus {
+
+    enum class ArchiveCompression : uint32_t {
+        None,
+        Lz4
+    };
+
+    // Index entry as stored in the archive, read in place from the mapping
+    struct ArchiveEntry {
+        uint32_t NameOffset;
+        uint32_t NameLength;
+        uint64_t Offset;
+        uint64_t StoredSize;
+        uint64_t Size;
+        // Hash64 of the uncompressed bytes, entries with the same content share their data
+        uint64_t ContentHash;
+        ArchiveCompression Compression;
+        uint32_t Reserved;
+    };
+
+    /* Baked assets packed into one file ".hpak" with an index sorted by name, so a cold start opens and maps a
+       single file instead of one per asset and finds entries with a binary search. Entries are aligned like cache
+       sections, stored ones are used in place and the rest are LZ4 compressed when that saves enough to be worth
+       the decode. */
+    class AssetArchive {
+    public:
+        static constexpr uint32_t VERSION = 1;
+
+        // Archive packed from a directory, stored next to it as "<directory>.hpak"
+        static std::filesystem::path GetArchivePath(const std::filesystem::path &directory);
+
+        explicit AssetArchive(const std::filesystem::path &path);
+
+        // Names are generic paths like the sources the runtime loads, "assets/models/Moon/Moon 2K.obj.hmesh"
+        const ArchiveEntry *Find(std::string_view name) const;
+
+        std::string_view GetName(const ArchiveEntry &entry) const;
+
+        std::span<const ArchiveEntry> GetEntries() const {
+            return m_Entries;
+        }
+
+        /* Stored entries are returned straight from the mapping, compressed ones are decompressed into storage and
+           checked against their hash. Empty when the entry is corrupt. */
+        std::optional<std::span<const std::byte>> Read(const ArchiveEntry &entry,
+                                                       std::vector<std::byte> &storage) const;
+
+        /* Packs every file below directory, named by its path relative to the parent of directory so the names
+           match the sources the runtime loads. Returns the number of entries. */
+        static uint32_t Pack(const std::filesystem::path &directory, const std::filesystem::path &archivePath,
+                             ThreadPool *pool = nullptr);
+
+    private:
+        MappedFile m_File;
+        std::span<const ArchiveEntry> m_Entries;
+        std::string_view m_Names;
+    };
+
+} // Haus
+
+#endif //HAUS_ASSETARCHIVE_H
@@ -0,0 +1,174 @@
+#include "AssetCompiler.h"
+#include "AssetArchive.h"
+#include "MeshCache.h"
+#include "TextureCache.h"
+
+#include <algorithm>
+#include <cctype>
+#include <format>
+#include <iostream>
+
+namespace Haus {
+    namespace {
+        constexpr uint64_t MESH_STREAMING_THRESHOLD = 64 << 20;
+
+        enum class AssetType {
+            Mesh,
+            Texture,
+            Other
+        };
+
+        AssetType GetAssetType(const std::filesystem::path &path) {
+            std::string extension = path.extension().string();
+            std::ranges::transform(extension, extension.begin(), [](unsigned char c) {
+                return static_cast<char>(std::tolower(c));
+            });
+
+            if (extension == ".obj")
+                return AssetType::Mesh;
+            if (extension == ".png" || extension == ".jpg" || extension == ".jpeg" || extension == ".tga")
+                return AssetType::Texture;
+
+            return AssetType::Other;
+        }
+
+        // Texture entries are "<image>.ktx2", KTX2 files authored elsewhere are copied like any other file
+        bool IsCacheFile(const std::filesystem::path &path) {
+            if (path.extension() == ".ktx2")
+                return GetAssetType(path.stem()) == AssetType::Texture;
+
+            return path.extension() == ".hmesh" || path.extension() == ".tmp";
+        }
+    }
+
+    MeshImportOptions AssetCompiler::GetMeshOptions() {
+        // Large files are streamed, so neither haus-assetc nor a runtime import next to the renderer holds their
+        // corners on top of the welded mesh, smaller ones are parsed on all threads
+        return {
+                .StreamingThreshold = MESH_STREAMING_THRESHOLD,
+                .Optimize = true,
+                .Layout = {
+                        .Position = VertexPositionFormat::Snorm16,
+                        .Color = false,
+                        .Deinterleaved = true
+                },
+                .GenerateMeshlets = true,
+                .LodCount = 4
+        };
+    }
+
+    TextureImportOptions AssetCompiler::GetTextureOptions(bool blockCompression) {
+        return {
+                .Compression = blockCompression ? TextureCompression::BC7 : TextureCompression::None
+        };
+    }
+
+    TextureImportOptions AssetCompiler::GetNormalMapOptions(bool blockCompression) {
+        return {
+                .Usage = TextureUsage::HeightToNormal,
+                .Compression = blockCompression ? TextureCompression::BC5 : TextureCompression::None
+        };
+    }
+
+    bool AssetCompiler::IsHeightMap(const std::filesystem::path &source) {
+        std::string stem = source.stem().string();
+        std::ranges::transform(stem, stem.begin(), [](unsigned char c) {
+            return static_cast<char>(std::tolower(c));
+        });
+
+        return stem.find("bump") != std::string::npos || stem.find("height") != std::string::npos;
+    }
+
+    AssetCompilerStats AssetCompiler::Compile(const std::filesystem::path &sourceDirectory,
+                                              const std::filesystem::path &outputDirectory) {
+        if (!std::filesystem::is_directory(sourceDirectory))
+            throw std::runtime_error("AssetCompiler: " + sourceDirectory.string() + " is not a directory");
+
+        MeshImportOptions meshOptions = GetMeshOptions();
+        TextureImportOptions textureOptions = GetTextureOptions();
+        TextureImportOptions normalMapOptions = GetNormalMapOptions();
+        AssetCompilerStats stats{};
+        ThreadPool pool;
+
+        struct TextureJob {
+            std::filesystem::path Source;
+            std::filesystem::path CachePath;
+            const TextureImportOptions *Options;
+            uint64_t Key;
+        };
+        std::vector<TextureJob> textureJobs;
+
+        for (const auto &entry: std::filesystem::recursive_directory_iterator(sourceDirectory)) {
+            if (!entry.is_regular_file() || IsCacheFile(entry.path()))
+                continue;
+
+            const std::filesystem::path &source = entry.path();
+            std::filesystem::path output = outputDirectory / std::filesystem::relative(source, sourceDirectory);
+            std::filesystem::create_directories(output.parent_path());
+
+            switch (GetAssetType(source)) {
+                case AssetType::Mesh: {
+                    std::filesystem::path cachePath = MeshCache::GetCachePath(output);
+                    uint64_t key = MeshCache::ComputeKey(source, meshOptions);
+                    if (MeshCache::Load(cachePath, key)) {
+                        stats.UpToDate++;
+                        break;
+                    }
+
+                    std::cout << std::format("Baking {}", source.string()) << "\n";
+                    MeshImportStats importStats{};
+                    MeshData mesh = MeshImporter::ImportObj(source, meshOptions, &pool, &importStats);
+
+                    const VertexWelderStats &weld = importStats.Weld;
+                    std::cout << std::format("  Welded {} corners into {} vertices ({} hits, {:.2f} probes per lookup)",
+                                             weld.Lookups, weld.Lookups - weld.Hits, weld.Hits,
+                                             weld.Lookups ? static_cast<double>(weld.Probes) / weld.Lookups : 0.0)
+                              << "\n";
+
+                    if (meshOptions.Optimize) {
+                        const MeshOptimizerStats &vertexCache = importStats.VertexCache;
+                        std::cout << std::format("  Optimized ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}",
+                                                 vertexCache.Before.ACMR, vertexCache.After.ACMR,
+                                                 vertexCache.Before.ATVR, vertexCache.After.ATVR) << "\n";
+                    }
+
+                    // Baked meshes are read far more often than written, they are worth the smaller file
+                    MeshCache::Store(cachePath, key, mesh.View(), true);
+                    stats.Compiled++;
+                    break;
+                }
+                case AssetType::Texture: {
+                    const TextureImportOptions &options = IsHeightMap(source) ? normalMapOptions : textureOptions;
+                    std::filesystem::path cachePath = TextureCache::GetCachePath(output);
+                    uint64_t key = TextureCache::ComputeKey(source, options);
+                    if (TextureCache::Load(cachePath, key)) {
+                        stats.UpToDate++;
+                        break;
+                    }
+
+                    textureJobs.push_back({source, cachePath, &options, key});
+                    break;
+                }
+                case AssetType::Other:
+                    std::filesystem::copy_file(source, output, std::filesystem::copy_options::update_existing);
+                    stats.Copied++;
+                    break;
+            }
+        }
+
+        // Decoding is serial within an image, so the images themselves are baked side by side
+        ParallelFor(&pool, textureJobs.size(), 1, [&](size_t begin, size_t end) {
+            for (const TextureJob &job: std::span(textureJobs).subspan(begin, end - begin)) {
+                std::cout << std::format("Baking {}", job.Source.string()) << "\n";
+                TextureData texture = TextureImporter::Import(job.Source, *job.Options, &pool);
+                TextureCache::Store(job.CachePath, job.Key, texture.View());
+            }
+        });
+        stats.Compiled += static_cast<uint32_t>(textureJobs.size());
+
+        // Repacked as a whole, compressing is cheap next to baking even a single texture
+        stats.Packed = AssetArchive::Pack(outputDirectory, AssetArchive::GetArchivePath(outputDirectory), &pool);
+
+        return stats;
+    }
+} // Haus
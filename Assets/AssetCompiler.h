@@ -0,0 +1,42 @@
+#ifndef HAUS_ASSETCOMPILER_H
+#define HAUS_ASSETCOMPILER_H
+
+#include "MeshImporter.h"
+#include "TextureImporter.h"
+
+#include <filesystem>
+
+namespace Haus {
+
+    struct AssetCompilerStats {
+        uint32_t Compiled = 0;
+        uint32_t UpToDate = 0;
+        uint32_t Copied = 0;
+        uint32_t Packed = 0;
+    };
+
+    /* Bakes source assets into the cache formats the runtime maps directly: OBJ meshes into ".hmesh" and
+       images into KTX2 files with their full mip chain. Used offline by haus-assetc, the runtime shares the import
+       options so it can still bake a missing or stale entry itself when the sources are present. */
+    class AssetCompiler {
+    public:
+        static MeshImportOptions GetMeshOptions();
+
+        // Without block compression for devices that cannot sample BC formats, as RGBA8 and RG8
+        static TextureImportOptions GetTextureOptions(bool blockCompression = true);
+
+        static TextureImportOptions GetNormalMapOptions(bool blockCompression = true);
+
+        // Images named as bump or height maps are baked into normal maps
+        static bool IsHeightMap(const std::filesystem::path &source);
+
+        /* Mirrors sourceDirectory into outputDirectory, replacing every mesh and image with its baked entry
+           and copying everything else. Entries whose key still matches are left alone. The output is then packed
+           into the archive next to it, the loose files stay for the next incremental bake and for hot reload. */
+        static AssetCompilerStats Compile(const std::filesystem::path &sourceDirectory,
+                                          const std::filesystem::path &outputDirectory);
+    };
+
+} // Haus
+
+#endif //HAUS_ASSETCOMPILER_H
@@ -0,0 +1,131 @@
+#include "AssetLoader.h"
+
+#include <cmath>
+#include <format>
+#include <iostream>
+
+namespace Haus {
+    LoadedMesh AssetLoader::LoadMesh(const std::filesystem::path &source, const MeshImportOptions &options,
+                                     ThreadPool *pool, const AssetArchive *archive) {
+        std::filesystem::path cachePath = MeshCache::GetCachePath(source);
+
+        // Baked assets ship without their source, so there is no key to check them against
+        std::optional<uint64_t> cacheKey;
+        if (std::filesystem::exists(source))
+            cacheKey = MeshCache::ComputeKey(source, options);
+
+        LoadedMesh mesh{};
+        if (!cacheKey && archive)
+            mesh.Cached = MeshCache::Load(*archive, cachePath);
+        if (!mesh.Cached)
+            mesh.Cached = MeshCache::Load(cachePath, cacheKey);
+        if (mesh.Cached) {
+            std::cout << std::format("Loaded {} from mesh cache", source.string()) << "\n";
+            return mesh;
+        }
+
+        if (!cacheKey)
+            throw std::runtime_error("AssetLoader: " + source.string() + " has neither a source nor a cache entry");
+
+        mesh.Imported = MeshImporter::ImportObj(source, options, pool);
+        MeshCache::Store(cachePath, *cacheKey, mesh.Imported.View());
+
+        return mesh;
+    }
+
+    LoadedTexture AssetLoader::LoadTexture(const std::filesystem::path &source, const TextureImportOptions &options,
+                                           ThreadPool *pool, const AssetArchive *archive) {
+        LoadedTexture texture{};
+
+        // Already GPU-ready, mapped as is
+        if (source.extension() == ".ktx2") {
+            if (archive)
+                texture.Cached = TextureCache::LoadKtx2(*archive, source);
+            if (!texture.Cached)
+                texture.Cached = TextureCache::LoadKtx2(source);
+            if (!texture.Cached)
+                throw std::runtime_error("AssetLoader: " + source.string() + " is not a supported KTX2 file");
+
+            return texture;
+        }
+
+        std::filesystem::path cachePath = TextureCache::GetCachePath(source);
+
+        std::optional<uint64_t> cacheKey;
+        if (std::filesystem::exists(source))
+            cacheKey = TextureCache::ComputeKey(source, options);
+
+        if (!cacheKey && archive)
+            texture.Cached = TextureCache::Load(*archive, cachePath);
+        if (!texture.Cached)
+            texture.Cached = TextureCache::Load(cachePath, cacheKey);
+        if (texture.Cached)
+            return texture;
+
+        if (!cacheKey)
+            throw std::runtime_error("AssetLoader: " + source.string() + " has neither a source nor a cache entry");
+
+        texture.Imported = TextureImporter::Import(source, options, pool);
+        TextureCache::Store(cachePath, *cacheKey, texture.Imported.View());
+
+        return texture;
+    }
+
+    MeshData AssetLoader::CreatePlaceholderMesh(const VertexLayout &layout) {
+        const glm::vec3 COLOR{0.5f, 0.5f, 0.5f};
+        const glm::vec3 NORMALS[] = {
+                {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, -1.0f}, {1.0f, 0.0f, 0.0f},
+                {-1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, -1.0f, 0.0f}
+        };
+        const glm::vec2 CORNERS[] = {{0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f, 1.0f}, {0.0f, 1.0f}};
+
+        MeshData mesh{};
+        for (const glm::vec3 &normal: NORMALS) {
+            // Two axes spanning the face, ordered so the corners wind counter-clockwise seen from outside
+            glm::vec3 u = std::abs(normal.y) > 0.5f ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+            glm::vec3 v = glm::cross(normal, u);
+
+            auto first = static_cast<uint32_t>(mesh.Vertices.size());
+            for (const glm::vec2 &corner: CORNERS) {
+                glm::vec3 position = normal * 0.5f + u * (corner.x - 0.5f) + v * (corner.y - 0.5f);
+                mesh.Vertices.push_back({position, COLOR, corner, normal, glm::vec4(u, 1.0f)});
+            }
+
+            for (uint32_t index: {0u, 1u, 2u, 2u, 3u, 0u})
+                mesh.Indices.push_back(first + index);
+        }
+
+        auto indexCount = static_cast<uint32_t>(mesh.Indices.size());
+        mesh.Bounds = {glm::vec3(-0.5f), glm::vec3(0.5f)};
+        mesh.Batches.push_back({0, indexCount, 0});
+        mesh.Lods.push_back({0, indexCount, 0, 1, 0, 0, 0.0f});
+        mesh.Layout = layout;
+        mesh.Packed = VertexPacker::Pack(mesh.Vertices, layout);
+
+        return mesh;
+    }
+
+    TextureData AssetLoader::CreatePlaceholderTexture() {
+        TextureData texture{
+                .Format = vk::Format::eR8G8B8A8Srgb,
+                .Width = 1,
+                .Height = 1,
+                .Mips = {{0, 4, 1, 1}},
+                .Pixels = {std::byte{128}, std::byte{128}, std::byte{128}, std::byte{255}}
+        };
+
+        return texture;
+    }
+
+    TextureData AssetLoader::CreatePlaceholderNormalMap() {
+        TextureData texture{
+                .Format = vk::Format::eR8G8Unorm,
+                .Width = 1,
+                .Height = 1,
+                .Mips = {{0, 2, 1, 1}},
+                .Pixels = {std::byte{128}, std::byte{128}}
+        };
+
+        return texture;
+    }
+} // Haus
@@ -0,0 +1,54 @@
+#ifndef HAUS_ASSETLOADER_H
+#define HAUS_ASSETLOADER_H
+
+#include "MeshCache.h"
+#include "TextureCache.h"
+
+#include <filesystem>
+#include <optional>
+
+namespace Haus {
+
+    // Mesh ready for upload, either mapped from its cache entry or freshly imported
+    struct LoadedMesh {
+        std::optional<CachedMesh> Cached;
+        MeshData Imported;
+
+        MeshView View() const {
+            return Cached ? Cached->View() : Imported.View();
+        }
+    };
+
+    struct LoadedTexture {
+        std::optional<CachedTexture> Cached;
+        TextureData Imported;
+
+        TextureView View() const {
+            return Cached ? Cached->View() : Imported.View();
+        }
+    };
+
+    /* CPU side of asset loading, safe to run on worker threads. Loads the cache entry next to the source and
+       falls back to importing, and storing, the source when the entry is missing or stale. Baked assets shipped
+       without their source are looked up in the archive first, when there is one. */
+    class AssetLoader {
+    public:
+        static LoadedMesh LoadMesh(const std::filesystem::path &source, const MeshImportOptions &options,
+                                   ThreadPool *pool = nullptr, const AssetArchive *archive = nullptr);
+
+        static LoadedTexture LoadTexture(const std::filesystem::path &source, const TextureImportOptions &options,
+                                         ThreadPool *pool = nullptr, const AssetArchive *archive = nullptr);
+
+        // Unit cube in the given layout, shown until the real mesh has been uploaded
+        static MeshData CreatePlaceholderMesh(const VertexLayout &layout);
+
+        // Single grey texel, shown until the real texture has been uploaded
+        static TextureData CreatePlaceholderTexture();
+
+        // Single flat normal as RG8, shown until the real normal map has been uploaded
+        static TextureData CreatePlaceholderNormalMap();
+    };
+
+} // Haus
+
+#endif //HAUS_ASSETLOADER_H
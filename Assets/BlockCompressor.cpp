@@ -0,0 +1,719 @@
+#include "BlockCompressor.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace Haus {
+    namespace {
+        constexpr uint32_t BLOCK_SIZE = 4;
+        constexpr uint32_t BLOCK_TEXELS = BLOCK_SIZE * BLOCK_SIZE;
+        constexpr uint32_t CHANNELS = 4;
+
+        // Where each index sits between the two endpoints, in the order the formats number their indices
+        constexpr float BC1_WEIGHTS[] = {0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+        constexpr float BC4_WEIGHTS[] = {0.0f, 1.0f, 1.0f / 7.0f, 2.0f / 7.0f, 3.0f / 7.0f, 4.0f / 7.0f, 5.0f / 7.0f,
+                                         6.0f / 7.0f};
+        constexpr uint32_t BC7_WEIGHTS[] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+        // One 4x4 block, channel-major so the index search can load eight texels of a channel at once
+        struct Block {
+            alignas(32) float Channels[CHANNELS][BLOCK_TEXELS];
+        };
+
+        struct Palette {
+            float Colors[16][CHANNELS];
+            uint32_t Count;
+        };
+
+        float FindIndicesScalar(const Block &block, const Palette &palette, const float weights[CHANNELS],
+                                uint8_t indices[BLOCK_TEXELS]) {
+            float total = 0.0f;
+            for (uint32_t i = 0; i < BLOCK_TEXELS; i++) {
+                float best = FLT_MAX;
+                for (uint32_t k = 0; k < palette.Count; k++) {
+                    float error = 0.0f;
+                    for (uint32_t c = 0; c < CHANNELS; c++) {
+                        float difference = block.Channels[c][i] - palette.Colors[k][c];
+                        error += difference * difference * weights[c];
+                    }
+
+                    if (error < best) {
+                        best = error;
+                        indices[i] = static_cast<uint8_t>(k);
+                    }
+                }
+                total += best;
+            }
+            return total;
+        }
+
+#if defined(__x86_64__)
+        __attribute__((target("avx2,fma")))
+        float FindIndicesAvx2(const Block &block, const Palette &palette, const float weights[CHANNELS],
+                              uint8_t indices[BLOCK_TEXELS]) {
+            float total = 0.0f;
+            for (uint32_t half = 0; half < BLOCK_TEXELS; half += 8) {
+                __m256 texels[CHANNELS];
+                for (uint32_t c = 0; c < CHANNELS; c++)
+                    texels[c] = _mm256_load_ps(block.Channels[c] + half);
+
+                __m256 best = _mm256_set1_ps(FLT_MAX);
+                __m256i bestIndex = _mm256_setzero_si256();
+
+                for (uint32_t k = 0; k < palette.Count; k++) {
+                    __m256 error = _mm256_setzero_ps();
+                    for (uint32_t c = 0; c < CHANNELS; c++) {
+                        __m256 difference = _mm256_sub_ps(texels[c], _mm256_set1_ps(palette.Colors[k][c]));
+                        error = _mm256_fmadd_ps(_mm256_mul_ps(difference, difference), _mm256_set1_ps(weights[c]),
+                                                error);
+                    }
+
+                    __m256 less = _mm256_cmp_ps(error, best, _CMP_LT_OQ);
+                    best = _mm256_blendv_ps(best, error, less);
+                    bestIndex = _mm256_blendv_epi8(bestIndex, _mm256_set1_epi32(static_cast<int>(k)),
+                                                   _mm256_castps_si256(less));
+                }
+
+                alignas(32) float errors[8];
+                alignas(32) int32_t chosen[8];
+                _mm256_store_ps(errors, best);
+                _mm256_store_si256(reinterpret_cast<__m256i *>(chosen), bestIndex);
+
+                for (uint32_t i = 0; i < 8; i++) {
+                    indices[half + i] = static_cast<uint8_t>(chosen[i]);
+                    total += errors[i];
+                }
+            }
+            return total;
+        }
+#endif
+
+        // Picks the closest palette entry for every texel and returns the summed weighted squared error
+        float FindIndices(const Block &block, const Palette &palette, const float weights[CHANNELS],
+                          uint8_t indices[BLOCK_TEXELS]) {
+#if defined(__x86_64__)
+            static const bool avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+            if (avx2)
+                return FindIndicesAvx2(block, palette, weights, indices);
+#endif
+            return FindIndicesScalar(block, palette, weights, indices);
+        }
+
+        // Endpoints at the extent of the block along its principal axis, channels weighted zero are left at the mean
+        void ComputeEndpoints(const Block &block, const float weights[CHANNELS], float first[CHANNELS],
+                              float second[CHANNELS]) {
+            float mean[CHANNELS]{};
+            for (uint32_t c = 0; c < CHANNELS; c++) {
+                for (uint32_t i = 0; i < BLOCK_TEXELS; i++)
+                    mean[c] += block.Channels[c][i];
+                mean[c] /= BLOCK_TEXELS;
+            }
+
+            float covariance[CHANNELS][CHANNELS]{};
+            for (uint32_t i = 0; i < BLOCK_TEXELS; i++) {
+                for (uint32_t a = 0; a < CHANNELS; a++) {
+                    for (uint32_t b = 0; b < CHANNELS; b++) {
+                        covariance[a][b] += (block.Channels[a][i] - mean[a]) * (block.Channels[b][i] - mean[b]) *
+                                            (weights[a] > 0.0f && weights[b] > 0.0f ? 1.0f : 0.0f);
+                    }
+                }
+            }
+
+            // Power iteration, starting from the channel that varies the most
+            float axis[CHANNELS]{};
+            uint32_t widest = 0;
+            for (uint32_t c = 1; c < CHANNELS; c++) {
+                if (covariance[c][c] > covariance[widest][widest])
+                    widest = c;
+            }
+            axis[widest] = 1.0f;
+
+            for (uint32_t iteration = 0; iteration < 8; iteration++) {
+                float next[CHANNELS]{};
+                float length = 0.0f;
+                for (uint32_t a = 0; a < CHANNELS; a++) {
+                    for (uint32_t b = 0; b < CHANNELS; b++)
+                        next[a] += covariance[a][b] * axis[b];
+                    length += next[a] * next[a];
+                }
+
+                if (length < 1e-12f)
+                    break;
+
+                length = std::sqrt(length);
+                for (uint32_t c = 0; c < CHANNELS; c++)
+                    axis[c] = next[c] / length;
+            }
+
+            float minimum = 0.0f;
+            float maximum = 0.0f;
+            for (uint32_t i = 0; i < BLOCK_TEXELS; i++) {
+                float projection = 0.0f;
+                for (uint32_t c = 0; c < CHANNELS; c++)
+                    projection += (block.Channels[c][i] - mean[c]) * axis[c];
+
+                minimum = std::min(minimum, projection);
+                maximum = std::max(maximum, projection);
+            }
+
+            for (uint32_t c = 0; c < CHANNELS; c++) {
+                first[c] = std::clamp(mean[c] + axis[c] * minimum, 0.0f, 255.0f);
+                second[c] = std::clamp(mean[c] + axis[c] * maximum, 0.0f, 255.0f);
+            }
+        }
+
+        // Least squares endpoints for fixed indices, false when every texel uses the same index
+        bool RefineEndpoints(const Block &block, const uint8_t indices[BLOCK_TEXELS], const float *indexWeights,
+                             float first[CHANNELS], float second[CHANNELS]) {
+            float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+            float ax[CHANNELS]{};
+            float bx[CHANNELS]{};
+
+            for (uint32_t i = 0; i < BLOCK_TEXELS; i++) {
+                float t = indexWeights[indices[i]];
+                float s = 1.0f - t;
+
+                aa += s * s;
+                ab += s * t;
+                bb += t * t;
+                for (uint32_t c = 0; c < CHANNELS; c++) {
+                    ax[c] += s * block.Channels[c][i];
+                    bx[c] += t * block.Channels[c][i];
+                }
+            }
+
+            float determinant = aa * bb - ab * ab;
+            if (std::abs(determinant) < 1e-6f)
+                return false;
+
+            for (uint32_t c = 0; c < CHANNELS; c++) {
+                first[c] = std::clamp((ax[c] * bb - bx[c] * ab) / determinant, 0.0f, 255.0f);
+                second[c] = std::clamp((bx[c] * aa - ax[c] * ab) / determinant, 0.0f, 255.0f);
+            }
+            return true;
+        }
+
+        uint32_t GetRefinements(BlockCompressionQuality quality) {
+            switch (quality) {
+                case BlockCompressionQuality::Fast:
+                    return 0;
+                case BlockCompressionQuality::Normal:
+                    return 1;
+                case BlockCompressionQuality::High:
+                    return 3;
+            }
+            return 1;
+        }
+
+        uint16_t QuantizeRgb565(const float color[CHANNELS]) {
+            auto quantize = [](float value, float levels) {
+                return static_cast<uint16_t>(std::clamp(std::lround(value * levels / 255.0f), 0l,
+                                                        static_cast<long>(levels)));
+            };
+            return static_cast<uint16_t>(quantize(color[0], 31.0f) << 11 | quantize(color[1], 63.0f) << 5 |
+                                         quantize(color[2], 31.0f));
+        }
+
+        void DequantizeRgb565(uint16_t value, float color[CHANNELS]) {
+            uint32_t r = value >> 11 & 31, g = value >> 5 & 63, b = value & 31;
+            color[0] = static_cast<float>(r << 3 | r >> 2);
+            color[1] = static_cast<float>(g << 2 | g >> 4);
+            color[2] = static_cast<float>(b << 3 | b >> 2);
+            color[3] = 0.0f;
+        }
+
+        // Four color mode, the first endpoint is kept above the second so alpha never turns on
+        void EncodeBc1(const Block &block, uint32_t refinements, std::byte *output) {
+            const float weights[CHANNELS] = {1.0f, 1.0f, 1.0f, 0.0f};
+
+            float first[CHANNELS], second[CHANNELS];
+            ComputeEndpoints(block, weights, first, second);
+
+            float bestError = FLT_MAX;
+            for (uint32_t pass = 0; pass <= refinements; pass++) {
+                uint16_t endpoints[2] = {QuantizeRgb565(first), QuantizeRgb565(second)};
+                if (endpoints[0] < endpoints[1])
+                    std::swap(endpoints[0], endpoints[1]);
+
+                Palette palette{.Count = 4};
+                DequantizeRgb565(endpoints[0], palette.Colors[0]);
+                DequantizeRgb565(endpoints[1], palette.Colors[1]);
+                for (uint32_t k = 2; k < 4; k++) {
+                    for (uint32_t c = 0; c < CHANNELS; c++)
+                        palette.Colors[k][c] = palette.Colors[0][c] +
+                                               (palette.Colors[1][c] - palette.Colors[0][c]) * BC1_WEIGHTS[k];
+                }
+
+                uint8_t indices[BLOCK_TEXELS];
+                float error = FindIndices(block, palette, weights, indices);
+                if (error < bestError) {
+                    bestError = error;
+
+                    uint32_t bits = 0;
+                    for (uint32_t i = 0; i < BLOCK_TEXELS; i++)
+                        bits |= static_cast<uint32_t>(endpoints[0] == endpoints[1] ? 0 : indices[i]) << (2 * i);
+
+                    memcpy(output, endpoints, sizeof(endpoints));
+                    memcpy(output + sizeof(endpoints), &bits, sizeof(bits));
+                }
+
+                if (!RefineEndpoints(block, indices, BC1_WEIGHTS, first, second))
+                    break;
+            }
+        }
+
+        // Eight value mode of a single channel, the alpha half of BC3 and both halves of BC5
+        void EncodeBc4(const Block &block, uint32_t channel, uint32_t refinements, std::byte *output) {
+            const float weights[CHANNELS] = {1.0f, 0.0f, 0.0f, 0.0f};
+
+            Block single{};
+            std::copy_n(block.Channels[channel], BLOCK_TEXELS, single.Channels[0]);
+
+            float first[CHANNELS]{}, second[CHANNELS]{};
+            first[0] = *std::ranges::max_element(single.Channels[0]);
+            second[0] = *std::ranges::min_element(single.Channels[0]);
+
+            float bestError = FLT_MAX;
+            for (uint32_t pass = 0; pass <= refinements; pass++) {
+                auto high = static_cast<uint8_t>(std::lround(std::max(first[0], second[0])));
+                auto low = static_cast<uint8_t>(std::lround(std::min(first[0], second[0])));
+
+                Palette palette{.Count = 8};
+                for (uint32_t k = 0; k < 8; k++)
+                    palette.Colors[k][0] = static_cast<float>(high) + (static_cast<float>(low) - high) * BC4_WEIGHTS[k];
+
+                uint8_t indices[BLOCK_TEXELS];
+                float error = FindIndices(single, palette, weights, indices);
+                if (error < bestError) {
+                    bestError = error;
+
+                    // A flat block would otherwise fall into the six value mode
+                    uint64_t bits = 0;
+                    for (uint32_t i = 0; i < BLOCK_TEXELS; i++)
+                        bits |= static_cast<uint64_t>(high == low ? 0 : indices[i]) << (3 * i);
+
+                    output[0] = static_cast<std::byte>(high);
+                    output[1] = static_cast<std::byte>(low);
+                    for (uint32_t i = 0; i < 6; i++)
+                        output[2 + i] = static_cast<std::byte>(bits >> (8 * i));
+                }
+
+                if (!RefineEndpoints(single, indices, BC4_WEIGHTS, first, second))
+                    break;
+            }
+        }
+
+        // Appends fields to a 128-bit block, least significant bit first
+        class BitWriter {
+        public:
+            void Write(uint32_t value, uint32_t count) {
+                for (uint32_t i = 0; i < count; i++, m_Position++) {
+                    if (value >> i & 1)
+                        m_Bytes[m_Position / 8] |= static_cast<std::byte>(1u << (m_Position % 8));
+                }
+            }
+
+            void CopyTo(std::byte *output) const {
+                memcpy(output, m_Bytes, sizeof(m_Bytes));
+            }
+
+        private:
+            std::byte m_Bytes[16]{};
+            uint32_t m_Position = 0;
+        };
+
+        // Mode 6: one subset, RGBA endpoints of 7 bits plus a parity bit each, 4-bit indices
+        void EncodeBc7(const Block &block, uint32_t refinements, bool allParities, std::byte *output) {
+            const float weights[CHANNELS] = {1.0f, 1.0f, 1.0f, 1.0f};
+            float indexWeights[16];
+            for (uint32_t k = 0; k < 16; k++)
+                indexWeights[k] = static_cast<float>(BC7_WEIGHTS[k]) / 64.0f;
+
+            float first[CHANNELS], second[CHANNELS];
+            ComputeEndpoints(block, weights, first, second);
+
+            struct Encoding {
+                uint32_t Endpoints[2][CHANNELS];
+                uint32_t Parity[2];
+                uint8_t Indices[BLOCK_TEXELS];
+            };
+
+            Encoding best{};
+            float bestError = FLT_MAX;
+
+            for (uint32_t pass = 0; pass <= refinements; pass++) {
+                float passError = FLT_MAX;
+                uint8_t passIndices[BLOCK_TEXELS];
+
+                for (uint32_t parities = 0; parities < 4; parities++) {
+                    // Both endpoints sharing a parity covers the common cases, mixed ones are tried for quality
+                    Encoding encoding{.Parity = {parities & 1, parities >> 1}};
+                    if (!allParities && encoding.Parity[0] != encoding.Parity[1])
+                        continue;
+
+                    uint32_t values[2][CHANNELS];
+                    for (uint32_t c = 0; c < CHANNELS; c++) {
+                        const float endpoint[2] = {first[c], second[c]};
+                        for (uint32_t e = 0; e < 2; e++) {
+                            long quantized = std::lround((endpoint[e] - static_cast<float>(encoding.Parity[e])) / 2.0f);
+                            encoding.Endpoints[e][c] = static_cast<uint32_t>(std::clamp(quantized, 0l, 127l));
+                            values[e][c] = encoding.Endpoints[e][c] << 1 | encoding.Parity[e];
+                        }
+                    }
+
+                    Palette palette{.Count = 16};
+                    for (uint32_t k = 0; k < 16; k++) {
+                        for (uint32_t c = 0; c < CHANNELS; c++)
+                            palette.Colors[k][c] = static_cast<float>(
+                                    ((64 - BC7_WEIGHTS[k]) * values[0][c] + BC7_WEIGHTS[k] * values[1][c] + 32) >> 6);
+                    }
+
+                    float error = FindIndices(block, palette, weights, encoding.Indices);
+                    if (error < passError) {
+                        passError = error;
+                        std::copy_n(encoding.Indices, BLOCK_TEXELS, passIndices);
+                    }
+                    if (error < bestError) {
+                        bestError = error;
+                        best = encoding;
+                    }
+                }
+
+                if (!RefineEndpoints(block, passIndices, indexWeights, first, second))
+                    break;
+            }
+
+            // The anchor texel stores only three index bits, so its index has to be in the lower half
+            if (best.Indices[0] >= 8) {
+                std::swap(best.Endpoints[0], best.Endpoints[1]);
+                std::swap(best.Parity[0], best.Parity[1]);
+                for (uint8_t &index: best.Indices)
+                    index = static_cast<uint8_t>(15 - index);
+            }
+
+            BitWriter writer;
+            writer.Write(1u << 6, 7);
+            for (uint32_t c = 0; c < CHANNELS; c++) {
+                writer.Write(best.Endpoints[0][c], 7);
+                writer.Write(best.Endpoints[1][c], 7);
+            }
+            writer.Write(best.Parity[0], 1);
+            writer.Write(best.Parity[1], 1);
+            for (uint32_t i = 0; i < BLOCK_TEXELS; i++)
+                writer.Write(best.Indices[i], i == 0 ? 3 : 4);
+
+            writer.CopyTo(output);
+        }
+
+        // Reads fields of a 128-bit block, least significant bit first
+        class BitReader {
+        public:
+            explicit BitReader(const std::byte *bytes) {
+                memcpy(m_Bytes, bytes, sizeof(m_Bytes));
+            }
+
+            uint32_t Read(uint32_t count) {
+                uint32_t value = 0;
+                for (uint32_t i = 0; i < count; i++, m_Position++)
+                    value |= static_cast<uint32_t>(m_Bytes[m_Position / 8] >> (m_Position % 8) & 1) << i;
+                return value;
+            }
+
+        private:
+            uint8_t m_Bytes[16];
+            uint32_t m_Position = 0;
+        };
+
+        // Texels of a decoded block, row by row, four channels each
+        using DecodedBlock = uint8_t[BLOCK_TEXELS][CHANNELS];
+
+        void DecodeBc1(const std::byte *input, DecodedBlock &output) {
+            uint16_t endpoints[2];
+            uint32_t bits;
+            memcpy(endpoints, input, sizeof(endpoints));
+            memcpy(&bits, input + sizeof(endpoints), sizeof(bits));
+
+            float colors[4][CHANNELS];
+            DequantizeRgb565(endpoints[0], colors[0]);
+            DequantizeRgb565(endpoints[1], colors[1]);
+            bool threeColors = endpoints[0] <= endpoints[1];
+            for (uint32_t c = 0; c < 3; c++) {
+                if (threeColors) {
+                    colors[2][c] = (colors[0][c] + colors[1][c]) / 2.0f;
+                    colors[3][c] = 0.0f;
+                } else {
+                    colors[2][c] = colors[0][c] + (colors[1][c] - colors[0][c]) * BC1_WEIGHTS[2];
+                    colors[3][c] = colors[0][c] + (colors[1][c] - colors[0][c]) * BC1_WEIGHTS[3];
+                }
+            }
+
+            for (uint32_t i = 0; i < BLOCK_TEXELS; i++) {
+                uint32_t index = bits >> (2 * i) & 3;
+                for (uint32_t c = 0; c < 3; c++)
+                    output[i][c] = static_cast<uint8_t>(std::lround(colors[index][c]));
+                output[i][3] = threeColors && index == 3 ? 0 : 255;
+            }
+        }
+
+        void DecodeBc4(const std::byte *input, uint32_t channel, DecodedBlock &output) {
+            auto first = static_cast<float>(input[0]);
+            auto second = static_cast<float>(input[1]);
+
+            float values[8] = {first, second};
+            for (uint32_t k = 2; k < 8; k++) {
+                // The six value mode ends on the extremes instead of interpolating two more
+                if (first <= second)
+                    values[k] = k < 6 ? first + (second - first) * static_cast<float>(k - 1) / 5.0f : (k - 6) * 255.0f;
+                else
+                    values[k] = first + (second - first) * BC4_WEIGHTS[k];
+            }
+
+            uint64_t bits = 0;
+            for (uint32_t i = 0; i < 6; i++)
+                bits |= static_cast<uint64_t>(input[2 + i]) << (8 * i);
+
+            for (uint32_t i = 0; i < BLOCK_TEXELS; i++)
+                output[i][channel] = static_cast<uint8_t>(std::lround(values[bits >> (3 * i) & 7]));
+        }
+
+        void DecodeBc7(const std::byte *input, DecodedBlock &output) {
+            BitReader reader(input);
+            if (reader.Read(7) != 1u << 6)
+                throw std::invalid_argument("BlockCompressor: Only BC7 mode 6 blocks can be decoded");
+
+            uint32_t values[2][CHANNELS];
+            for (uint32_t c = 0; c < CHANNELS; c++) {
+                values[0][c] = reader.Read(7);
+                values[1][c] = reader.Read(7);
+            }
+            for (uint32_t e = 0; e < 2; e++) {
+                uint32_t parity = reader.Read(1);
+                for (uint32_t &value: values[e])
+                    value = value << 1 | parity;
+            }
+
+            for (uint32_t i = 0; i < BLOCK_TEXELS; i++) {
+                uint32_t weight = BC7_WEIGHTS[reader.Read(i == 0 ? 3 : 4)];
+                for (uint32_t c = 0; c < CHANNELS; c++)
+                    output[i][c] = static_cast<uint8_t>(((64 - weight) * values[0][c] + weight * values[1][c] + 32) >> 6);
+            }
+        }
+
+        // Texels past the edge of the level repeat the last row or column
+        void LoadBlock(const std::byte *pixels, uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY,
+                       Block &block) {
+            for (uint32_t y = 0; y < BLOCK_SIZE; y++) {
+                uint32_t sourceY = std::min(blockY * BLOCK_SIZE + y, height - 1);
+                for (uint32_t x = 0; x < BLOCK_SIZE; x++) {
+                    uint32_t sourceX = std::min(blockX * BLOCK_SIZE + x, width - 1);
+                    const std::byte *texel = pixels + (static_cast<size_t>(sourceY) * width + sourceX) * CHANNELS;
+
+                    for (uint32_t c = 0; c < CHANNELS; c++)
+                        block.Channels[c][y * BLOCK_SIZE + x] = static_cast<float>(texel[c]);
+                }
+            }
+        }
+
+        // Format the decoded texels are stored in, with the channels a decoded block keeps
+        vk::Format GetDecompressedFormat(vk::Format format, uint32_t &channels) {
+            channels = CHANNELS;
+            switch (format) {
+                case vk::Format::eBc1RgbSrgbBlock:
+                case vk::Format::eBc1RgbaSrgbBlock:
+                case vk::Format::eBc3SrgbBlock:
+                case vk::Format::eBc7SrgbBlock:
+                    return vk::Format::eR8G8B8A8Srgb;
+                case vk::Format::eBc5UnormBlock:
+                    channels = 2;
+                    return vk::Format::eR8G8Unorm;
+                default:
+                    return vk::Format::eR8G8B8A8Unorm;
+            }
+        }
+
+        vk::Format GetCompressedFormat(TextureCompression compression, bool srgb) {
+            switch (compression) {
+                case TextureCompression::BC1:
+                    return srgb ? vk::Format::eBc1RgbSrgbBlock : vk::Format::eBc1RgbUnormBlock;
+                case TextureCompression::BC3:
+                    return srgb ? vk::Format::eBc3SrgbBlock : vk::Format::eBc3UnormBlock;
+                case TextureCompression::BC5:
+                    return vk::Format::eBc5UnormBlock;
+                case TextureCompression::BC7:
+                    return srgb ? vk::Format::eBc7SrgbBlock : vk::Format::eBc7UnormBlock;
+                case TextureCompression::None:
+                    break;
+            }
+            throw std::invalid_argument("BlockCompressor: No compression selected");
+        }
+    }
+
+    bool BlockCompressor::IsBlockCompressed(vk::Format format) {
+        switch (format) {
+            case vk::Format::eBc1RgbUnormBlock:
+            case vk::Format::eBc1RgbSrgbBlock:
+            case vk::Format::eBc1RgbaUnormBlock:
+            case vk::Format::eBc1RgbaSrgbBlock:
+            case vk::Format::eBc3UnormBlock:
+            case vk::Format::eBc3SrgbBlock:
+            case vk::Format::eBc5UnormBlock:
+            case vk::Format::eBc7UnormBlock:
+            case vk::Format::eBc7SrgbBlock:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    TextureData BlockCompressor::Compress(const TextureView &texture, TextureCompression compression,
+                                          BlockCompressionQuality quality, ThreadPool *pool) {
+        if (texture.Format != vk::Format::eR8G8B8A8Srgb && texture.Format != vk::Format::eR8G8B8A8Unorm)
+            throw std::invalid_argument("BlockCompressor: Only RGBA8 textures can be compressed");
+        if (texture.Layers != 1)
+            throw std::invalid_argument("BlockCompressor: Texture arrays are compressed before they are packed");
+
+        TextureData compressed{
+                .Format = GetCompressedFormat(compression, texture.Format == vk::Format::eR8G8B8A8Srgb),
+                .Width = texture.Width,
+                .Height = texture.Height,
+        };
+
+        uint32_t blockBytes = compression == TextureCompression::BC1 ? 8 : 16;
+        uint64_t size = 0;
+        for (const TextureMip &mip: texture.Mips) {
+            uint64_t blocks = static_cast<uint64_t>((mip.Width + BLOCK_SIZE - 1) / BLOCK_SIZE) *
+                              ((mip.Height + BLOCK_SIZE - 1) / BLOCK_SIZE);
+            compressed.Mips.push_back({size, blocks * blockBytes, mip.Width, mip.Height});
+            size += blocks * blockBytes;
+        }
+        compressed.Pixels.resize(size);
+
+        uint32_t refinements = GetRefinements(quality);
+
+        for (size_t level = 0; level < texture.Mips.size(); level++) {
+            const TextureMip &source = texture.Mips[level];
+            const TextureMip &mip = compressed.Mips[level];
+            uint32_t blocksWide = (mip.Width + BLOCK_SIZE - 1) / BLOCK_SIZE;
+            uint32_t blocksHigh = (mip.Height + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+            // Rows of blocks, batched so a job holds a few hundred blocks
+            ParallelFor(pool, blocksHigh, std::max(1u, 256 / blocksWide), [&](size_t begin, size_t end) {
+                Block block;
+                for (auto blockY = static_cast<uint32_t>(begin); blockY < end; blockY++) {
+                    for (uint32_t blockX = 0; blockX < blocksWide; blockX++) {
+                        LoadBlock(texture.Data.data() + source.Offset, source.Width, source.Height, blockX, blockY,
+                                  block);
+                        std::byte *output = compressed.Pixels.data() + mip.Offset +
+                                            (static_cast<size_t>(blockY) * blocksWide + blockX) * blockBytes;
+
+                        switch (compression) {
+                            case TextureCompression::BC1:
+                                EncodeBc1(block, refinements, output);
+                                break;
+                            case TextureCompression::BC3:
+                                EncodeBc4(block, 3, refinements, output);
+                                EncodeBc1(block, refinements, output + 8);
+                                break;
+                            case TextureCompression::BC5:
+                                EncodeBc4(block, 0, refinements, output);
+                                EncodeBc4(block, 1, refinements, output + 8);
+                                break;
+                            case TextureCompression::BC7:
+                                EncodeBc7(block, refinements, quality != BlockCompressionQuality::Fast, output);
+                                break;
+                            case TextureCompression::None:
+                                break;
+                        }
+                    }
+                }
+            });
+        }
+
+        return compressed;
+    }
+
+    TextureData BlockCompressor::Decompress(const TextureView &texture, ThreadPool *pool) {
+        if (!IsBlockCompressed(texture.Format))
+            throw std::invalid_argument("BlockCompressor: Texture is not block compressed");
+
+        uint32_t channels;
+        TextureData decompressed{
+                .Format = GetDecompressedFormat(texture.Format, channels),
+                .Width = texture.Width,
+                .Height = texture.Height,
+                .Layers = texture.Layers
+        };
+
+        uint64_t size = 0;
+        for (const TextureMip &mip: texture.Mips) {
+            uint64_t texels = static_cast<uint64_t>(mip.Width) * mip.Height * texture.Layers;
+            decompressed.Mips.push_back({size, texels * channels, mip.Width, mip.Height});
+            size += texels * channels;
+        }
+        decompressed.Pixels.resize(size);
+
+        bool bc1 = texture.Format == vk::Format::eBc1RgbUnormBlock || texture.Format == vk::Format::eBc1RgbSrgbBlock ||
+                   texture.Format == vk::Format::eBc1RgbaUnormBlock || texture.Format == vk::Format::eBc1RgbaSrgbBlock;
+        uint32_t blockBytes = bc1 ? 8 : 16;
+
+        for (size_t level = 0; level < texture.Mips.size(); level++) {
+            const TextureMip &source = texture.Mips[level];
+            const TextureMip &mip = decompressed.Mips[level];
+            uint32_t blocksWide = (mip.Width + BLOCK_SIZE - 1) / BLOCK_SIZE;
+            uint32_t blocksHigh = (mip.Height + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+            // Layers follow each other within a level, their block rows are decoded like those of one tall image
+            ParallelFor(pool, static_cast<size_t>(blocksHigh) * texture.Layers, std::max(1u, 256 / blocksWide),
+                        [&](size_t begin, size_t end) {
+                DecodedBlock block{};
+                for (size_t row = begin; row < end; row++) {
+                    size_t layer = row / blocksHigh;
+                    auto blockY = static_cast<uint32_t>(row % blocksHigh);
+
+                    for (uint32_t blockX = 0; blockX < blocksWide; blockX++) {
+                        const std::byte *input = texture.Data.data() + source.Offset +
+                                                 (row * blocksWide + blockX) * blockBytes;
+
+                        switch (texture.Format) {
+                            case vk::Format::eBc3UnormBlock:
+                            case vk::Format::eBc3SrgbBlock:
+                                DecodeBc1(input + 8, block);
+                                DecodeBc4(input, 3, block);
+                                break;
+                            case vk::Format::eBc5UnormBlock:
+                                DecodeBc4(input, 0, block);
+                                DecodeBc4(input + 8, 1, block);
+                                break;
+                            case vk::Format::eBc7UnormBlock:
+                            case vk::Format::eBc7SrgbBlock:
+                                DecodeBc7(input, block);
+                                break;
+                            default:
+                                DecodeBc1(input, block);
+                                break;
+                        }
+
+                        // Texels past the edge of the level are dropped
+                        for (uint32_t y = 0; y < BLOCK_SIZE && blockY * BLOCK_SIZE + y < mip.Height; y++) {
+                            for (uint32_t x = 0; x < BLOCK_SIZE && blockX * BLOCK_SIZE + x < mip.Width; x++) {
+                                size_t texel = (layer * mip.Height + blockY * BLOCK_SIZE + y) * mip.Width +
+                                               blockX * BLOCK_SIZE + x;
+                                memcpy(decompressed.Pixels.data() + mip.Offset + texel * channels,
+                                       block[y * BLOCK_SIZE + x], channels);
+                            }
+                        }
+                    }
+                }
+            });
+        }
+
+        return decompressed;
+    }
+} // Haus
@@ -0,0 +1,48 @@
+#ifndef HAUS_BLOCKCOMPRESSOR_H
+#define HAUS_BLOCKCOMPRESSOR_H
+
+#include "Texture.h"
+#include "ThreadPool.h"
+
+namespace Haus {
+
+    enum class TextureCompression : uint32_t {
+        None,
+        // Opaque color, 4 bits per texel
+        BC1,
+        // Color with alpha, 8 bits per texel
+        BC3,
+        // Red and green only, for two-channel normal maps
+        BC5,
+        // Color with alpha at a much better quality than BC1 and BC3, 8 bits per texel
+        BC7
+    };
+
+    // Trades encoding time for quality, Fast is meant for textures compressed while the application runs
+    enum class BlockCompressionQuality : uint32_t {
+        Fast,
+        Normal,
+        High
+    };
+
+    /* Encoder for the BC formats. Endpoints come from the principal axis of each 4x4 block and are refined by
+       least squares on the chosen indices, the quality sets the number of refinement passes (and for BC7 how
+       many parity bits are tried). The index search is vectorized with AVX2 when the CPU has it, blocks are
+       spread over the pool. BC7 uses mode 6 only. The decoder is the fallback for devices that cannot sample
+       BC formats, so it only reads back what the encoder writes. */
+    class BlockCompressor {
+    public:
+        static bool IsBlockCompressed(vk::Format format);
+
+        // Compresses every mip level of an RGBA8 texture, sRGB input gives an sRGB format where one exists
+        static TextureData Compress(const TextureView &texture, TextureCompression compression,
+                                    BlockCompressionQuality quality, ThreadPool *pool);
+
+        /* Decodes every level back into RGBA8, or RG8 for BC5, keeping sRGB. BC7 blocks in any mode but 6 throw,
+           those only come from KTX2 files authored with other tools. */
+        static TextureData Decompress(const TextureView &texture, ThreadPool *pool);
+    };
+
+} // Haus
+
+#endif //HAUS_BLOCKCOMPRESSOR_H
@@ -0,0 +1,49 @@
+#include "CacheFile.h"
+
+#include <format>
+#include <iostream>
+#include <thread>
+#include <unistd.h>
+
+namespace Haus {
+    void CacheFile::WriteSection(std::ofstream &file, uint64_t offset, std::span<const std::byte> bytes) {
+        const char padding[SECTION_ALIGNMENT]{};
+        auto position = static_cast<uint64_t>(file.tellp());
+        file.write(padding, static_cast<std::streamsize>(offset - position));
+        file.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    }
+
+    bool CacheFile::Write(const std::filesystem::path &path, const std::function<void(std::ofstream &)> &write) {
+        // Unique per process and thread, so concurrent writers of the same entry never share a partial file
+        std::filesystem::path temporaryPath = path;
+        size_t thread = std::hash<std::thread::id>()(std::this_thread::get_id());
+        temporaryPath += std::format(".{}.{:x}.tmp", getpid(), thread);
+
+        std::error_code error;
+        {
+            std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) {
+                std::cerr << "CacheFile: Failed to write " << temporaryPath << "\n";
+                return false;
+            }
+
+            write(file);
+
+            if (!file.good()) {
+                std::cerr << "CacheFile: Failed to write " << temporaryPath << "\n";
+                file.close();
+                std::filesystem::remove(temporaryPath, error);
+                return false;
+            }
+        }
+
+        std::filesystem::rename(temporaryPath, path, error);
+        if (error) {
+            std::cerr << "CacheFile: Failed to store " << path << ": " << error.message() << "\n";
+            std::filesystem::remove(temporaryPath, error);
+            return false;
+        }
+
+        return true;
+    }
+} // Haus
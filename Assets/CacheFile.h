@@ -0,0 +1,36 @@
+#ifndef HAUS_CACHEFILE_H
+#define HAUS_CACHEFILE_H
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <span>
+
+namespace Haus {
+
+    // Helpers shared by the binary caches, sections are aligned so mapped data can be used in place
+    class CacheFile {
+    public:
+        static constexpr uint64_t SECTION_ALIGNMENT = 16;
+
+        static uint64_t AlignUp(uint64_t value) {
+            return (value + SECTION_ALIGNMENT - 1) & ~(SECTION_ALIGNMENT - 1);
+        }
+
+        static bool InBounds(uint64_t offset, uint64_t size, uint64_t fileSize) {
+            return offset <= fileSize && size <= fileSize - offset;
+        }
+
+        // Pads the file up to offset and writes the section there
+        static void WriteSection(std::ofstream &file, uint64_t offset, std::span<const std::byte> bytes);
+
+        /* Calls write on a temporary file of its own and renames it to path, so a crash, a concurrent reader or
+           another writer of the same path never sees a partial cache. Failures are reported and leave any previous
+           file in place. */
+        static bool Write(const std::filesystem::path &path, const std::function<void(std::ofstream &)> &write);
+    };
+
+} // Haus
+
+#endif //HAUS_CACHEFILE_H
@@ -0,0 +1,97 @@
+#include "Culling.h"
+
+#include <cmath>
+#include <limits>
+
+namespace Haus {
+    Frustum Frustum::FromMatrix(const glm::mat4 &viewProjection) {
+        auto row = [&](int i) {
+            return glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+        };
+
+        glm::vec4 x = row(0);
+        glm::vec4 y = row(1);
+        glm::vec4 z = row(2);
+        glm::vec4 w = row(3);
+
+        Frustum frustum{
+                .Planes = {w + x, w - x, w + y, w - y, z, w - z}
+        };
+
+        for (glm::vec4 &plane: frustum.Planes) {
+            float length = glm::length(glm::vec3(plane));
+            if (length > 0.0f)
+                plane = plane * (1.0f / length);
+        }
+
+        return frustum;
+    }
+
+    bool Frustum::IntersectsSphere(const glm::vec3 &center, float radius) const {
+        for (const glm::vec4 &plane: Planes) {
+            if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+                return false;
+        }
+
+        return true;
+    }
+
+    bool IsMeshletVisible(const Meshlet &meshlet, const glm::mat4 &transform, const Frustum &frustum,
+                          const glm::vec3 &cameraPosition) {
+        float scale = glm::length(glm::vec3(transform[0]));
+
+        glm::vec3 center = glm::vec3(transform * glm::vec4(meshlet.Center, 1.0f));
+        if (!frustum.IntersectsSphere(center, meshlet.Radius * scale))
+            return false;
+
+        if (meshlet.ConeCutoff >= 1.0f)
+            return true;
+
+        glm::vec3 apex = glm::vec3(transform * glm::vec4(meshlet.ConeApex, 1.0f));
+        glm::vec3 axis = glm::normalize(glm::vec3(transform * glm::vec4(meshlet.ConeAxis, 0.0f)));
+
+        float distance = glm::length(apex - cameraPosition);
+        if (distance == 0.0f)
+            return true;
+
+        return glm::dot((apex - cameraPosition) / distance, axis) < meshlet.ConeCutoff;
+    }
+
+    float GetProjectedDiameter(const BoundingBox &bounds, const glm::mat4 &transform, const glm::vec3 &cameraPosition,
+                               float projectionScale, float viewportHeight) {
+        float scale = glm::length(glm::vec3(transform[0]));
+        glm::vec3 center = glm::vec3(transform * glm::vec4((bounds.Min + bounds.Max) * 0.5f, 1.0f));
+        float radius = glm::length(bounds.Max - bounds.Min) * 0.5f * scale;
+
+        float distance = glm::length(center - cameraPosition) - radius;
+        if (distance <= 0.0f)
+            return std::numeric_limits<float>::infinity();
+
+        return 2.0f * radius * std::abs(projectionScale) * viewportHeight * 0.5f / distance;
+    }
+
+    uint32_t SelectLod(std::span<const MeshLod> lods, const BoundingBox &bounds, const glm::mat4 &transform,
+                       const glm::vec3 &cameraPosition, float projectionScale, float viewportHeight,
+                       float pixelThreshold) {
+        if (lods.size() <= 1)
+            return 0;
+
+        float scale = glm::length(glm::vec3(transform[0]));
+        glm::vec3 center = glm::vec3(transform * glm::vec4((bounds.Min + bounds.Max) * 0.5f, 1.0f));
+        float radius = glm::length(bounds.Max - bounds.Min) * 0.5f * scale;
+
+        // Nearest point of the bounding sphere, clamped so a camera inside the bounds keeps the full mesh
+        float distance = glm::length(center - cameraPosition) - radius;
+        if (distance <= 0.0f)
+            return 0;
+
+        float pixelsPerUnit = std::abs(projectionScale) * viewportHeight * 0.5f / distance;
+
+        for (auto level = static_cast<uint32_t>(lods.size() - 1); level > 0; level--) {
+            if (lods[level].Error * scale * pixelsPerUnit <= pixelThreshold)
+                return level;
+        }
+
+        return 0;
+    }
+} // Haus
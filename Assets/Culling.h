@@ -0,0 +1,34 @@
+#ifndef HAUS_CULLING_H
+#define HAUS_CULLING_H
+
+#include "Mesh.h"
+
+namespace Haus {
+
+    struct Frustum {
+        glm::vec4 Planes[6];
+
+        // Planes of a Vulkan (zero to one depth) view projection matrix, pointing inwards
+        static Frustum FromMatrix(const glm::mat4 &viewProjection);
+
+        bool IntersectsSphere(const glm::vec3 &center, float radius) const;
+    };
+
+    /* Frustum and normal cone test of a meshlet drawn with transform, which may only rotate, translate
+       and scale uniformly. cameraPosition is in the same space the transform maps into. */
+    bool IsMeshletVisible(const Meshlet &meshlet, const glm::mat4 &transform, const Frustum &frustum,
+                          const glm::vec3 &cameraPosition);
+
+    // Pixels the bounding sphere of the transformed bounds spans on screen, infinite with the camera inside it
+    float GetProjectedDiameter(const BoundingBox &bounds, const glm::mat4 &transform, const glm::vec3 &cameraPosition,
+                               float projectionScale, float viewportHeight);
+
+    /* Coarsest level of detail whose error, projected at the distance of the mesh bounds, stays within
+       pixelThreshold. projectionScale is the cotangent of half the vertical field of view, projection[1][1]. */
+    uint32_t SelectLod(std::span<const MeshLod> lods, const BoundingBox &bounds, const glm::mat4 &transform,
+                       const glm::vec3 &cameraPosition, float projectionScale, float viewportHeight,
+                       float pixelThreshold);
+
+} // Haus
+
+#endif //HAUS_CULLING_H
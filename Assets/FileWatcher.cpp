@@ -0,0 +1,83 @@
+#include "FileWatcher.h"
+
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+namespace Haus {
+    namespace {
+        // Editors usually write a temporary file and rename it over the original, which is a move
+        constexpr uint32_t WATCH_MASK = IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_ONLYDIR;
+    }
+
+    FileWatcher::FileWatcher(const std::filesystem::path &directory) {
+        m_Descriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (m_Descriptor < 0)
+            throw std::runtime_error(std::string("FileWatcher: inotify_init1 failed, ") + strerror(errno));
+
+        if (!AddWatch(directory))
+            throw std::runtime_error("FileWatcher: Failed to watch " + directory.string());
+
+        for (const auto &entry: std::filesystem::recursive_directory_iterator(directory)) {
+            if (entry.is_directory())
+                AddWatch(entry.path());
+        }
+    }
+
+    FileWatcher::~FileWatcher() {
+        close(m_Descriptor);
+    }
+
+    bool FileWatcher::AddWatch(const std::filesystem::path &directory) {
+        int watch = inotify_add_watch(m_Descriptor, directory.c_str(), WATCH_MASK);
+        if (watch < 0) {
+            std::cerr << "FileWatcher: Failed to watch " << directory << ", " << strerror(errno) << "\n";
+            return false;
+        }
+
+        m_Directories[watch] = directory;
+        return true;
+    }
+
+    std::vector<std::filesystem::path> FileWatcher::Poll() {
+        std::vector<std::filesystem::path> changed;
+        alignas(inotify_event) char buffer[4096];
+
+        while (true) {
+            ssize_t size = read(m_Descriptor, buffer, sizeof(buffer));
+            if (size <= 0)
+                break;
+
+            for (ssize_t offset = 0; offset < size;) {
+                auto *event = reinterpret_cast<const inotify_event *>(buffer + offset);
+                offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+                auto directory = m_Directories.find(event->wd);
+                if (directory == m_Directories.end() || event->len == 0)
+                    continue;
+
+                std::filesystem::path path = directory->second / event->name;
+                if (event->mask & IN_ISDIR) {
+                    // Skipped when it is already gone, nothing below it can change anymore
+                    if (event->mask & (IN_CREATE | IN_MOVED_TO))
+                        AddWatch(path);
+                    continue;
+                }
+
+                // A created file is reported again once it has been written and closed
+                if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO))
+                    changed.push_back(path);
+            }
+        }
+
+        std::ranges::sort(changed);
+        changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+
+        return changed;
+    }
+} // Haus
@@ -0,0 +1,35 @@
+#ifndef HAUS_FILEWATCHER_H
+#define HAUS_FILEWATCHER_H
+
+#include <filesystem>
+#include <unordered_map>
+#include <vector>
+
+namespace Haus {
+
+    /* Watches a directory tree with inotify for files that were written or moved into place. Directories
+       created later are watched as they appear. Poll never blocks, it is meant to be called once per frame. */
+    class FileWatcher {
+    public:
+        explicit FileWatcher(const std::filesystem::path &directory);
+
+        ~FileWatcher();
+
+        FileWatcher(const FileWatcher &) = delete;
+
+        FileWatcher &operator=(const FileWatcher &) = delete;
+
+        // Files changed since the last call, each listed once
+        std::vector<std::filesystem::path> Poll();
+
+    private:
+        // Fails when the directory is gone again, removed or renamed before its creation was polled
+        bool AddWatch(const std::filesystem::path &directory);
+
+        int m_Descriptor = -1;
+        std::unordered_map<int, std::filesystem::path> m_Directories;
+    };
+
+} // Haus
+
+#endif //HAUS_FILEWATCHER_H
@@ -0,0 +1,65 @@
+#ifndef HAUS_HASH_H
+#define HAUS_HASH_H
+
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+namespace Haus {
+
+    // splitmix64 finalizer, used to spread the bits of a single 64-bit word
+    inline uint64_t HashMix(uint64_t value) {
+        value ^= value >> 30;
+        value *= 0xBF58476D1CE4E5B9ull;
+        value ^= value >> 27;
+        value *= 0x94D049BB133111EBull;
+        value ^= value >> 31;
+        return value;
+    }
+
+    inline uint64_t HashCombine(uint64_t seed, uint64_t value) {
+        return HashMix(seed ^ (value + 0x9E3779B97F4A7C15ull + (seed << 6) + (seed >> 2)));
+    }
+
+    // Fast non-cryptographic 64-bit hash over raw bytes, used for content-addressed cache keys.
+    // Consumes 32 bytes per iteration in four independent lanes so large assets hash at memory speed.
+    inline uint64_t Hash64(const void *data, size_t size, uint64_t seed = 0) {
+        constexpr uint64_t prime = 0x9E3779B97F4A7C15ull;
+        auto bytes = static_cast<const unsigned char *>(data);
+
+        uint64_t lanes[4] = {seed ^ prime, seed + prime, ~seed, seed * prime + 1};
+        size_t remaining = size;
+
+        while (remaining >= 32) {
+            for (uint64_t &lane: lanes) {
+                uint64_t word;
+                memcpy(&word, bytes, sizeof(word));
+                lane = (lane ^ HashMix(word)) * prime;
+                lane = (lane << 31) | (lane >> 33);
+                bytes += sizeof(word);
+            }
+            remaining -= 32;
+        }
+
+        uint64_t hash = HashCombine(HashCombine(lanes[0], lanes[1]), HashCombine(lanes[2], lanes[3]));
+
+        while (remaining >= 8) {
+            uint64_t word;
+            memcpy(&word, bytes, sizeof(word));
+            hash = HashCombine(hash, word);
+            bytes += 8;
+            remaining -= 8;
+        }
+
+        uint64_t tail = 0;
+        memcpy(&tail, bytes, remaining);
+        return HashCombine(hash, tail ^ (static_cast<uint64_t>(size) << 56));
+    }
+
+    inline uint64_t Hash64(std::span<const std::byte> bytes, uint64_t seed = 0) {
+        return Hash64(bytes.data(), bytes.size(), seed);
+    }
+
+} // Haus
+
+#endif //HAUS_HASH_H
@@ -0,0 +1,292 @@
+#include "Ktx2.h"
+#include "CacheFile.h"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+
+namespace Haus {
+    namespace {
+        constexpr uint8_t IDENTIFIER[12] = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+
+        struct Ktx2Header {
+            uint8_t Identifier[12];
+            uint32_t VkFormat;
+            uint32_t TypeSize;
+            uint32_t PixelWidth;
+            uint32_t PixelHeight;
+            uint32_t PixelDepth;
+            uint32_t LayerCount;
+            uint32_t FaceCount;
+            uint32_t LevelCount;
+            uint32_t SupercompressionScheme;
+            uint32_t DfdByteOffset;
+            uint32_t DfdByteLength;
+            uint32_t KvdByteOffset;
+            uint32_t KvdByteLength;
+            uint64_t SgdByteOffset;
+            uint64_t SgdByteLength;
+        };
+
+        static_assert(sizeof(Ktx2Header) == 80, "Ktx2Header must match the file layout");
+
+        struct Ktx2Level {
+            uint64_t ByteOffset;
+            uint64_t ByteLength;
+            uint64_t UncompressedByteLength;
+        };
+
+        // Data format descriptor values from the Khronos Data Format Specification
+        constexpr uint8_t MODEL_RGBSDA = 1;
+        constexpr uint8_t MODEL_BC1A = 128;
+        constexpr uint8_t MODEL_BC3 = 130;
+        constexpr uint8_t MODEL_BC5 = 132;
+        constexpr uint8_t MODEL_BC7 = 134;
+        constexpr uint8_t PRIMARIES_BT709 = 1;
+        constexpr uint8_t TRANSFER_LINEAR = 1;
+        constexpr uint8_t TRANSFER_SRGB = 2;
+        constexpr uint8_t SAMPLE_LINEAR = 0x10;
+        constexpr uint8_t CHANNEL_ALPHA = 15;
+
+        struct FormatSample {
+            uint8_t Channel;
+            uint8_t BitOffset;
+            uint8_t BitLength;
+        };
+
+        struct FormatInfo {
+            vk::Format Format;
+            uint8_t Model;
+            bool Srgb;
+            uint32_t BlockSize;
+            uint32_t BlockBytes;
+            std::vector<FormatSample> Samples;
+        };
+
+        const std::vector<FormatInfo> &GetFormats() {
+            static const std::vector<FormatInfo> formats = {
+                    {vk::Format::eR8Unorm, MODEL_RGBSDA, false, 1, 1, {{0, 0, 8}}},
+                    {vk::Format::eR8G8Unorm, MODEL_RGBSDA, false, 1, 2, {{0, 0, 8}, {1, 8, 8}}},
+                    {vk::Format::eR8G8B8A8Unorm, MODEL_RGBSDA, false, 1, 4,
+                     {{0, 0, 8}, {1, 8, 8}, {2, 16, 8}, {CHANNEL_ALPHA, 24, 8}}},
+                    {vk::Format::eR8G8B8A8Srgb, MODEL_RGBSDA, true, 1, 4,
+                     {{0, 0, 8}, {1, 8, 8}, {2, 16, 8}, {CHANNEL_ALPHA, 24, 8}}},
+                    {vk::Format::eBc1RgbUnormBlock, MODEL_BC1A, false, 4, 8, {{0, 0, 64}}},
+                    {vk::Format::eBc1RgbSrgbBlock, MODEL_BC1A, true, 4, 8, {{0, 0, 64}}},
+                    {vk::Format::eBc1RgbaUnormBlock, MODEL_BC1A, false, 4, 8, {{1, 0, 64}}},
+                    {vk::Format::eBc1RgbaSrgbBlock, MODEL_BC1A, true, 4, 8, {{1, 0, 64}}},
+                    {vk::Format::eBc3UnormBlock, MODEL_BC3, false, 4, 16, {{CHANNEL_ALPHA, 0, 64}, {0, 64, 64}}},
+                    {vk::Format::eBc3SrgbBlock, MODEL_BC3, true, 4, 16, {{CHANNEL_ALPHA, 0, 64}, {0, 64, 64}}},
+                    {vk::Format::eBc5UnormBlock, MODEL_BC5, false, 4, 16, {{0, 0, 64}, {1, 64, 64}}},
+                    {vk::Format::eBc7UnormBlock, MODEL_BC7, false, 4, 16, {{0, 0, 128}}},
+                    {vk::Format::eBc7SrgbBlock, MODEL_BC7, true, 4, 16, {{0, 0, 128}}},
+            };
+            return formats;
+        }
+
+        const FormatInfo *FindFormat(vk::Format format) {
+            for (const FormatInfo &info: GetFormats()) {
+                if (info.Format == format)
+                    return &info;
+            }
+            return nullptr;
+        }
+
+        uint64_t GetLevelSize(const FormatInfo &info, uint32_t width, uint32_t height) {
+            uint64_t blocksWide = (width + info.BlockSize - 1) / info.BlockSize;
+            uint64_t blocksHigh = (height + info.BlockSize - 1) / info.BlockSize;
+            return blocksWide * blocksHigh * info.BlockBytes;
+        }
+
+        uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+
+        // Basic descriptor block, one sample per channel (per 64-bit half for block compressed formats)
+        std::vector<uint32_t> CreateDataFormatDescriptor(const FormatInfo &info) {
+            auto blockSize = static_cast<uint32_t>(24 + 16 * info.Samples.size());
+
+            std::vector<uint32_t> words;
+            words.push_back(4 + blockSize);
+            words.push_back(0);
+            words.push_back(2 | (blockSize << 16));
+            words.push_back(info.Model | (PRIMARIES_BT709 << 8) | ((info.Srgb ? TRANSFER_SRGB : TRANSFER_LINEAR) << 16));
+            words.push_back((info.BlockSize - 1) | ((info.BlockSize - 1) << 8));
+            words.push_back(info.BlockBytes);
+            words.push_back(0);
+
+            for (const FormatSample &sample: info.Samples) {
+                // Alpha is never sRGB encoded, the flag marks it as linear in an sRGB format
+                uint8_t channelType = sample.Channel;
+                if (info.Srgb && sample.Channel == CHANNEL_ALPHA)
+                    channelType |= SAMPLE_LINEAR;
+
+                bool compressed = info.BlockSize > 1;
+                words.push_back(sample.BitOffset | ((sample.BitLength - 1u) << 16) |
+                                (static_cast<uint32_t>(channelType) << 24));
+                words.push_back(0);
+                words.push_back(0);
+                words.push_back(compressed ? UINT32_MAX : (1u << sample.BitLength) - 1);
+            }
+
+            return words;
+        }
+    }
+
+    std::optional<std::span<const std::byte>> Ktx2Contents::FindValue(std::string_view key) const {
+        for (const Ktx2KeyValue &keyValue: KeyValues) {
+            if (keyValue.Key == key)
+                return keyValue.Value;
+        }
+        return std::nullopt;
+    }
+
+    bool Ktx2::IsFormatSupported(vk::Format format) {
+        return FindFormat(format) != nullptr;
+    }
+
+    std::optional<Ktx2Contents> Ktx2::Parse(std::span<const std::byte> bytes) {
+        Ktx2Header header{};
+        if (bytes.size() < sizeof(header))
+            return std::nullopt;
+
+        memcpy(&header, bytes.data(), sizeof(header));
+
+        const FormatInfo *info = FindFormat(static_cast<vk::Format>(header.VkFormat));
+        if (memcmp(header.Identifier, IDENTIFIER, sizeof(IDENTIFIER)) != 0 || !info || header.PixelWidth == 0 ||
+            header.PixelHeight == 0 || header.PixelDepth != 0 || header.FaceCount != 1 ||
+            header.SupercompressionScheme != 0)
+            return std::nullopt;
+
+        // A layer count of zero marks a single image rather than an array of one
+        uint32_t layers = std::max(header.LayerCount, 1u);
+
+        // A level count of zero asks the loader to generate the mips, only the base level is stored
+        uint32_t levelCount = std::max(header.LevelCount, 1u);
+        if (levelCount > 32 || !CacheFile::InBounds(sizeof(header), levelCount * sizeof(Ktx2Level), bytes.size()))
+            return std::nullopt;
+
+        std::vector<Ktx2Level> levels(levelCount);
+        memcpy(levels.data(), bytes.data() + sizeof(header), levelCount * sizeof(Ktx2Level));
+
+        uint64_t dataBegin = UINT64_MAX;
+        uint64_t dataEnd = 0;
+        for (uint32_t level = 0; level < levelCount; level++) {
+            uint32_t width = std::max(header.PixelWidth >> level, 1u);
+            uint32_t height = std::max(header.PixelHeight >> level, 1u);
+
+            if (levels[level].ByteLength != GetLevelSize(*info, width, height) * layers ||
+                levels[level].ByteOffset % info->BlockBytes != 0 ||
+                !CacheFile::InBounds(levels[level].ByteOffset, levels[level].ByteLength, bytes.size()))
+                return std::nullopt;
+
+            dataBegin = std::min(dataBegin, levels[level].ByteOffset);
+            dataEnd = std::max(dataEnd, levels[level].ByteOffset + levels[level].ByteLength);
+        }
+
+        Ktx2Contents contents{
+                .Format = info->Format,
+                .Width = header.PixelWidth,
+                .Height = header.PixelHeight,
+                .Layers = layers,
+                .Data = bytes.subspan(dataBegin, dataEnd - dataBegin)
+        };
+
+        for (uint32_t level = 0; level < levelCount; level++) {
+            contents.Mips.push_back({
+                    levels[level].ByteOffset - dataBegin, levels[level].ByteLength,
+                    std::max(header.PixelWidth >> level, 1u), std::max(header.PixelHeight >> level, 1u)
+            });
+        }
+
+        if (!CacheFile::InBounds(header.KvdByteOffset, header.KvdByteLength, bytes.size()))
+            return std::nullopt;
+
+        std::span<const std::byte> kvd = bytes.subspan(header.KvdByteOffset, header.KvdByteLength);
+        while (kvd.size() >= sizeof(uint32_t)) {
+            uint32_t length;
+            memcpy(&length, kvd.data(), sizeof(length));
+            if (length > kvd.size() - sizeof(length))
+                return std::nullopt;
+
+            std::span<const std::byte> entry = kvd.subspan(sizeof(length), length);
+            auto terminator = std::ranges::find(entry, std::byte{0});
+            if (terminator == entry.end())
+                return std::nullopt;
+
+            auto keyLength = static_cast<size_t>(terminator - entry.begin());
+            contents.KeyValues.push_back({
+                    std::string(reinterpret_cast<const char *>(entry.data()), keyLength),
+                    entry.subspan(keyLength + 1)
+            });
+
+            kvd = kvd.subspan(std::min<uint64_t>(AlignUp(sizeof(length) + length, 4), kvd.size()));
+        }
+
+        return contents;
+    }
+
+    void Ktx2::Write(std::ofstream &file, const TextureView &texture, std::span<const Ktx2KeyValue> keyValues) {
+        const FormatInfo *info = FindFormat(texture.Format);
+        if (!info)
+            throw std::runtime_error("Ktx2: Unsupported format");
+
+        auto levelCount = static_cast<uint32_t>(texture.Mips.size());
+        std::vector<uint32_t> dfd = CreateDataFormatDescriptor(*info);
+
+        // Entries are sorted by key, each padded to four bytes
+        std::vector<Ktx2KeyValue> sorted(keyValues.begin(), keyValues.end());
+        std::ranges::sort(sorted, {}, &Ktx2KeyValue::Key);
+
+        std::vector<std::byte> kvd;
+        for (const Ktx2KeyValue &keyValue: sorted) {
+            auto length = static_cast<uint32_t>(keyValue.Key.size() + 1 + keyValue.Value.size());
+            size_t offset = kvd.size();
+            kvd.resize(AlignUp(offset + sizeof(length) + length, 4));
+
+            memcpy(kvd.data() + offset, &length, sizeof(length));
+            memcpy(kvd.data() + offset + sizeof(length), keyValue.Key.data(), keyValue.Key.size());
+            memcpy(kvd.data() + offset + sizeof(length) + keyValue.Key.size() + 1, keyValue.Value.data(),
+                   keyValue.Value.size());
+        }
+
+        Ktx2Header header{
+                .VkFormat = static_cast<uint32_t>(texture.Format),
+                .TypeSize = 1,
+                .PixelWidth = texture.Width,
+                .PixelHeight = texture.Height,
+                .PixelDepth = 0,
+                .LayerCount = texture.Layers > 1 ? texture.Layers : 0,
+                .FaceCount = 1,
+                .LevelCount = levelCount,
+                .SupercompressionScheme = 0,
+                .DfdByteOffset = static_cast<uint32_t>(sizeof(Ktx2Header) + levelCount * sizeof(Ktx2Level)),
+                .DfdByteLength = static_cast<uint32_t>(dfd.size() * sizeof(uint32_t)),
+        };
+        memcpy(header.Identifier, IDENTIFIER, sizeof(IDENTIFIER));
+        header.KvdByteOffset = kvd.empty() ? 0 : header.DfdByteOffset + header.DfdByteLength;
+        header.KvdByteLength = static_cast<uint32_t>(kvd.size());
+
+        // Smallest level first, each aligned to both the block size and four bytes
+        uint64_t alignment = std::lcm<uint64_t>(info->BlockBytes, 4);
+        uint64_t offset = header.DfdByteOffset + header.DfdByteLength + kvd.size();
+
+        std::vector<Ktx2Level> levels(levelCount);
+        for (uint32_t level = levelCount; level-- > 0;) {
+            offset = AlignUp(offset, alignment);
+            levels[level] = {offset, texture.Mips[level].Size, texture.Mips[level].Size};
+            offset += texture.Mips[level].Size;
+        }
+
+        CacheFile::WriteSection(file, 0, std::as_bytes(std::span(&header, 1)));
+        CacheFile::WriteSection(file, sizeof(header), std::as_bytes(std::span(levels)));
+        CacheFile::WriteSection(file, header.DfdByteOffset, std::as_bytes(std::span(dfd)));
+        CacheFile::WriteSection(file, header.DfdByteOffset + header.DfdByteLength, kvd);
+
+        for (uint32_t level = levelCount; level-- > 0;) {
+            CacheFile::WriteSection(file, levels[level].ByteOffset,
+                                    texture.Data.subspan(texture.Mips[level].Offset, texture.Mips[level].Size));
+        }
+    }
+} // Haus
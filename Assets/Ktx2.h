@@ -0,0 +1,45 @@
+#ifndef HAUS_KTX2_H
+#define HAUS_KTX2_H
+
+#include "Texture.h"
+
+#include <fstream>
+#include <optional>
+#include <string>
+
+namespace Haus {
+
+    struct Ktx2KeyValue {
+        std::string Key;
+        std::span<const std::byte> Value;
+    };
+
+    // Parsed KTX2 file, the spans point into the bytes it was parsed from
+    struct Ktx2Contents {
+        vk::Format Format = vk::Format::eUndefined;
+        uint32_t Width = 0;
+        uint32_t Height = 0;
+        uint32_t Layers = 1;
+        // Offsets are relative to Data, which covers every level
+        std::vector<TextureMip> Mips;
+        std::span<const std::byte> Data;
+        std::vector<Ktx2KeyValue> KeyValues;
+
+        std::optional<std::span<const std::byte>> FindValue(std::string_view key) const;
+    };
+
+    /* Khronos KTX2 container for 2D images and 2D arrays with their mip chain, without supercompression. Levels
+       are stored smallest first and aligned so every one can be a region of the same buffer to image copy. */
+    class Ktx2 {
+    public:
+        static bool IsFormatSupported(vk::Format format);
+
+        // Files this reader does not handle (cube maps, volumes, supercompression, other formats) are rejected
+        static std::optional<Ktx2Contents> Parse(std::span<const std::byte> bytes);
+
+        static void Write(std::ofstream &file, const TextureView &texture, std::span<const Ktx2KeyValue> keyValues);
+    };
+
+} // Haus
+
+#endif //HAUS_KTX2_H
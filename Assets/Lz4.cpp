@@ -0,0 +1,185 @@
+#include "Lz4.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace Haus {
+    namespace {
+        constexpr size_t MIN_MATCH = 4;
+        // The block format ends with literals, the last match has to start this far from the end
+        constexpr size_t MATCH_LIMIT = 12;
+        constexpr size_t LAST_LITERALS = 5;
+        constexpr size_t MAX_OFFSET = 65535;
+
+        constexpr uint32_t HASH_BITS = 16;
+        // Every miss in a row skips further ahead, incompressible data is passed over quickly
+        constexpr uint32_t SKIP_SHIFT = 6;
+
+        uint32_t Read32(const uint8_t *data) {
+            uint32_t value;
+            memcpy(&value, data, sizeof(value));
+            return value;
+        }
+
+        uint32_t HashSequence(uint32_t sequence) {
+            return (sequence * 2654435761u) >> (32 - HASH_BITS);
+        }
+
+        // Lengths from 15 on continue in bytes of 255 and a final smaller one
+        void WriteLength(std::vector<std::byte> &output, size_t length) {
+            for (; length >= 255; length -= 255)
+                output.push_back(std::byte{255});
+            output.push_back(static_cast<std::byte>(length));
+        }
+
+        void WriteSequence(std::vector<std::byte> &output, const uint8_t *literals, size_t literalLength,
+                           size_t offset, size_t matchLength) {
+            size_t matchCode = matchLength - MIN_MATCH;
+            auto token = static_cast<uint8_t>((std::min<size_t>(literalLength, 15) << 4) |
+                                              std::min<size_t>(matchCode, 15));
+            output.push_back(static_cast<std::byte>(token));
+            if (literalLength >= 15)
+                WriteLength(output, literalLength - 15);
+
+            const auto *begin = reinterpret_cast<const std::byte *>(literals);
+            output.insert(output.end(), begin, begin + literalLength);
+
+            output.push_back(static_cast<std::byte>(offset & 0xFF));
+            output.push_back(static_cast<std::byte>(offset >> 8));
+            if (matchCode >= 15)
+                WriteLength(output, matchCode - 15);
+        }
+
+        void WriteLastLiterals(std::vector<std::byte> &output, const uint8_t *literals, size_t literalLength) {
+            output.push_back(static_cast<std::byte>(std::min<size_t>(literalLength, 15) << 4));
+            if (literalLength >= 15)
+                WriteLength(output, literalLength - 15);
+
+            const auto *begin = reinterpret_cast<const std::byte *>(literals);
+            output.insert(output.end(), begin, begin + literalLength);
+        }
+
+        bool ReadLength(const uint8_t *&input, const uint8_t *end, size_t &length) {
+            uint8_t byte;
+            do {
+                if (input == end)
+                    return false;
+
+                byte = *input++;
+                length += byte;
+            } while (byte == 255);
+
+            return true;
+        }
+    }
+
+    std::vector<std::byte> Lz4::Compress(std::span<const std::byte> source) {
+        std::vector<std::byte> output;
+        output.reserve(source.size() / 2 + 16);
+
+        const auto *data = reinterpret_cast<const uint8_t *>(source.data());
+        size_t size = source.size();
+        size_t anchor = 0;
+
+        if (size > MATCH_LIMIT) {
+            // Positions are stored plus one, zero marks an empty slot
+            std::vector<uint32_t> table(size_t(1) << HASH_BITS, 0);
+            size_t matchLimit = size - MATCH_LIMIT;
+            size_t position = 0;
+            uint32_t misses = 0;
+
+            while (position < matchLimit) {
+                uint32_t sequence = Read32(data + position);
+                uint32_t &slot = table[HashSequence(sequence)];
+                size_t candidate = slot;
+                slot = static_cast<uint32_t>(position + 1);
+
+                if (candidate == 0 || position - (candidate - 1) > MAX_OFFSET ||
+                    Read32(data + candidate - 1) != sequence) {
+                    position += 1 + (misses++ >> SKIP_SHIFT);
+                    continue;
+                }
+                candidate--;
+                misses = 0;
+
+                // Extend backwards over literals that also match, then forwards up to the literal tail
+                while (position > anchor && candidate > 0 && data[position - 1] == data[candidate - 1]) {
+                    position--;
+                    candidate--;
+                }
+
+                size_t length = MIN_MATCH;
+                size_t lengthLimit = size - LAST_LITERALS - position;
+                while (length < lengthLimit && data[position + length] == data[candidate + length])
+                    length++;
+
+                WriteSequence(output, data + anchor, position - anchor, position - candidate, length);
+                position += length;
+                anchor = position;
+
+                // The positions inside the match are not hashed, only the one just before its end
+                if (position - 2 < matchLimit)
+                    table[HashSequence(Read32(data + position - 2))] = static_cast<uint32_t>(position - 1);
+            }
+        }
+
+        WriteLastLiterals(output, data + anchor, size - anchor);
+        return output;
+    }
+
+    bool Lz4::Decompress(std::span<const std::byte> compressed, std::span<std::byte> destination) {
+        const auto *input = reinterpret_cast<const uint8_t *>(compressed.data());
+        const uint8_t *inputEnd = input + compressed.size();
+        auto *output = reinterpret_cast<uint8_t *>(destination.data());
+        uint8_t *outputBegin = output;
+        uint8_t *outputEnd = output + destination.size();
+
+        while (input < inputEnd) {
+            uint8_t token = *input++;
+
+            size_t literalLength = token >> 4;
+            if (literalLength == 15 && !ReadLength(input, inputEnd, literalLength))
+                return false;
+
+            if (literalLength > static_cast<size_t>(inputEnd - input) ||
+                literalLength > static_cast<size_t>(outputEnd - output))
+                return false;
+
+            memcpy(output, input, literalLength);
+            input += literalLength;
+            output += literalLength;
+
+            // The last sequence has no match
+            if (input == inputEnd)
+                break;
+
+            if (inputEnd - input < 2)
+                return false;
+
+            size_t offset = input[0] | (input[1] << 8);
+            input += 2;
+
+            size_t matchLength = token & 15;
+            if (matchLength == 15 && !ReadLength(input, inputEnd, matchLength))
+                return false;
+            matchLength += MIN_MATCH;
+
+            if (offset == 0 || offset > static_cast<size_t>(output - outputBegin) ||
+                matchLength > static_cast<size_t>(outputEnd - output))
+                return false;
+
+            // Overlapping matches repeat the bytes just written, so they are copied front to back
+            const uint8_t *match = output - offset;
+            if (offset >= matchLength) {
+                memcpy(output, match, matchLength);
+            } else {
+                for (size_t i = 0; i < matchLength; i++)
+                    output[i] = match[i];
+            }
+            output += matchLength;
+        }
+
+        return output == outputEnd;
+    }
+} // Haus
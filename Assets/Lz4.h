@@ -0,0 +1,23 @@
+#ifndef HAUS_LZ4_H
+#define HAUS_LZ4_H
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace Haus {
+
+    /* Byte-oriented LZ compression in the LZ4 block format, so entries stay readable by the reference tools.
+       Matches are found greedily through a single hash table of 4 byte sequences and copied from up to 64KB
+       back, decoding is a loop of plain copies that runs at memory speed. */
+    class Lz4 {
+    public:
+        static std::vector<std::byte> Compress(std::span<const std::byte> source);
+
+        // Returns false on malformed input, destination must hold exactly the decompressed size
+        static bool Decompress(std::span<const std::byte> compressed, std::span<std::byte> destination);
+    };
+
+} // Haus
+
+#endif //HAUS_LZ4_H
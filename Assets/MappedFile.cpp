@@ -0,0 +1,121 @@
+#include "MappedFile.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <stdexcept>
+#include <utility>
+
+namespace Haus {
+    namespace {
+        int GetAdvice(MappedFileAccess access) {
+            switch (access) {
+                case MappedFileAccess::Sequential:
+                    return MADV_SEQUENTIAL;
+                case MappedFileAccess::Random:
+                    return MADV_RANDOM;
+                case MappedFileAccess::WillNeed:
+                    return MADV_WILLNEED;
+                default:
+                    return MADV_NORMAL;
+            }
+        }
+
+        uintptr_t GetPageSize() {
+            static const auto pageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+            return pageSize;
+        }
+
+        // madvise wants a page aligned start, the range is widened to the pages it touches
+        void AdvisePages(std::span<const std::byte> range, int advice) {
+            if (range.empty())
+                return;
+
+            auto begin = reinterpret_cast<uintptr_t>(range.data()) & ~(GetPageSize() - 1);
+            auto end = reinterpret_cast<uintptr_t>(range.data() + range.size());
+
+            // Only a hint, a failure leaves the mapping as it was
+            madvise(reinterpret_cast<void *>(begin), end - begin, advice);
+        }
+    }
+
+    MappedFile::MappedFile(const std::filesystem::path &path, MappedFileAccess access) {
+        int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            throw std::runtime_error("Failed to open file " + path.string());
+
+        struct stat info{};
+        if (fstat(fd, &info) != 0) {
+            close(fd);
+            throw std::runtime_error("Failed to stat file " + path.string());
+        }
+
+        m_Size = static_cast<size_t>(info.st_size);
+        m_Open = true;
+
+        // mmap rejects zero-length mappings, an empty file is simply an empty span
+        if (m_Size > 0) {
+            void *data = mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED) {
+                close(fd);
+                throw std::runtime_error("Failed to map file " + path.string());
+            }
+            m_Data = data;
+
+            if (access != MappedFileAccess::Normal)
+                madvise(m_Data, m_Size, GetAdvice(access));
+        }
+
+        // The mapping keeps its own reference to the file
+        close(fd);
+    }
+
+    MappedFile::~MappedFile() {
+        Close();
+    }
+
+    MappedFile::MappedFile(MappedFile &&other) noexcept
+            : m_Data(std::exchange(other.m_Data, nullptr)),
+              m_Size(std::exchange(other.m_Size, 0)),
+              m_Open(std::exchange(other.m_Open, false)) {}
+
+    MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+        if (this != &other) {
+            Close();
+            m_Data = std::exchange(other.m_Data, nullptr);
+            m_Size = std::exchange(other.m_Size, 0);
+            m_Open = std::exchange(other.m_Open, false);
+        }
+
+        return *this;
+    }
+
+    void MappedFile::Advise(std::span<const std::byte> range, MappedFileAccess access) const {
+        AdvisePages(range, GetAdvice(access));
+    }
+
+    void MappedFile::Release(std::span<const std::byte> range) const {
+        // madvise would round the length up, dropping the page the range ends in along with the bytes after it
+        auto end = reinterpret_cast<uintptr_t>(range.data() + range.size());
+        if (range.data() + range.size() != GetData() + m_Size)
+            end &= ~(GetPageSize() - 1);
+
+        auto begin = reinterpret_cast<uintptr_t>(range.data());
+        if (end <= begin)
+            return;
+
+        // Private read-only pages are never dirty, dropping them only costs a reread
+        AdvisePages({range.data(), static_cast<size_t>(end - begin)}, MADV_DONTNEED);
+    }
+
+    void MappedFile::Close() {
+        if (m_Data)
+            munmap(m_Data, m_Size);
+
+        m_Data = nullptr;
+        m_Size = 0;
+        m_Open = false;
+    }
+} // Haus
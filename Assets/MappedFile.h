@@ -0,0 +1,73 @@
+#ifndef HAUS_MAPPEDFILE_H
+#define HAUS_MAPPEDFILE_H
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+namespace Haus {
+
+    // How a mapping is about to be read, passed on to madvise so the kernel reads ahead, or not, to match
+    enum class MappedFileAccess {
+        Normal,
+        // Front to back once, read ahead aggressively and the pages behind may be dropped early
+        Sequential,
+        // Scattered ranges, like the levels of a streamed texture, no read ahead
+        Random,
+        // All of it soon, read in before the first access faults
+        WillNeed
+    };
+
+    /* Read-only memory mapping of a whole file. Loaders read assets through the span instead of copying them into
+       buffers of their own, so the bytes are only ever held by the page cache and copied once, into the staging
+       buffer or the decoder's output. */
+    class MappedFile {
+    public:
+        MappedFile() = default;
+
+        explicit MappedFile(const std::filesystem::path &path, MappedFileAccess access = MappedFileAccess::Normal);
+
+        ~MappedFile();
+
+        MappedFile(const MappedFile &) = delete;
+
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        MappedFile(MappedFile &&other) noexcept;
+
+        MappedFile &operator=(MappedFile &&other) noexcept;
+
+        bool IsOpen() const {
+            return m_Open;
+        }
+
+        const std::byte *GetData() const {
+            return static_cast<const std::byte *>(m_Data);
+        }
+
+        size_t GetSize() const {
+            return m_Size;
+        }
+
+        std::span<const std::byte> GetSpan() const {
+            return {GetData(), m_Size};
+        }
+
+        // Access hint for part of the mapping, widened to whole pages
+        void Advise(std::span<const std::byte> range, MappedFileAccess access) const;
+
+        /* Drops the pages of a range that has been read, touching it again reads it back from the file. The page the
+           range ends in is kept unless the range ends the file, it still holds the bytes that come next. */
+        void Release(std::span<const std::byte> range) const;
+
+    private:
+        void Close();
+
+        void *m_Data = nullptr;
+        size_t m_Size = 0;
+        bool m_Open = false;
+    };
+
+} // Haus
+
+#endif //HAUS_MAPPEDFILE_H
@@ -0,0 +1,106 @@
+#ifndef HAUS_MESH_H
+#define HAUS_MESH_H
+
+#include "VertexLayout.h"
+
+#include <span>
+#include <vector>
+
+namespace Haus {
+
+    struct BoundingBox {
+        glm::vec3 Min;
+        glm::vec3 Max;
+    };
+
+    enum class IndexFormat : uint32_t {
+        UInt16,
+        UInt32
+    };
+
+    // One indexed draw, indices are relative to VertexOffset so every batch stays addressable with 16-bit indices
+    struct MeshBatch {
+        uint32_t FirstIndex;
+        uint32_t IndexCount;
+        int32_t VertexOffset;
+    };
+
+    /* Cluster of up to 64 vertices and 124 triangles with bounds for culling. The cluster is back facing for
+       every viewer with dot(normalize(ConeApex - viewer), ConeAxis) >= ConeCutoff, a cutoff of 1 never culls. */
+    struct Meshlet {
+        glm::vec3 Center;
+        float Radius;
+        glm::vec3 ConeApex;
+        float ConeCutoff;
+        glm::vec3 ConeAxis;
+        uint32_t FirstIndex;
+        uint32_t IndexCount;
+        int32_t VertexOffset;
+    };
+
+    // Level of detail, a range of batches and meshlets that all index the shared vertex buffer
+    struct MeshLod {
+        uint32_t FirstIndex;
+        uint32_t IndexCount;
+        uint32_t FirstBatch;
+        uint32_t BatchCount;
+        uint32_t FirstMeshlet;
+        uint32_t MeshletCount;
+        float Error; // Largest deviation from the full detail mesh in object space
+    };
+
+    // Non-owning view of GPU-ready mesh geometry, either imported (MeshData) or mapped from the mesh cache
+    struct MeshView {
+        VertexLayout Layout;
+        VertexQuantization Quantization;
+        uint32_t VertexCount = 0;
+        std::span<const std::byte> VertexData;
+        IndexFormat IndexType = IndexFormat::UInt32;
+        uint32_t IndexCount = 0;
+        std::span<const std::byte> IndexData;
+        std::span<const MeshBatch> Batches;
+        std::span<const Meshlet> Meshlets;
+        std::span<const MeshLod> Lods;
+        BoundingBox Bounds{};
+    };
+
+    struct MeshData {
+        std::vector<Vertex> Vertices;
+        std::vector<uint32_t> Indices;
+        BoundingBox Bounds{};
+
+        // Vertices encoded for Layout, empty for the fp32 layout which uses Vertices directly
+        VertexLayout Layout;
+        PackedVertices Packed;
+
+        // Indices narrowed to 16 bits when every batch fits, empty for 32-bit meshes which use Indices directly
+        IndexFormat IndexType = IndexFormat::UInt32;
+        std::vector<uint16_t> Indices16;
+        std::vector<MeshBatch> Batches;
+        std::vector<Meshlet> Meshlets;
+        std::vector<MeshLod> Lods;
+
+        MeshView View() const {
+            std::span<const std::byte> vertexData = Layout.IsVertexStruct() ? std::as_bytes(std::span(Vertices))
+                                                                             : std::span<const std::byte>(Packed.Data);
+            std::span<const std::byte> indexData = IndexType == IndexFormat::UInt16 ? std::as_bytes(std::span(Indices16))
+                                                                                    : std::as_bytes(std::span(Indices));
+            return {
+                    .Layout = Layout,
+                    .Quantization = Packed.Quantization,
+                    .VertexCount = static_cast<uint32_t>(Vertices.size()),
+                    .VertexData = vertexData,
+                    .IndexType = IndexType,
+                    .IndexCount = static_cast<uint32_t>(Indices.size()),
+                    .IndexData = indexData,
+                    .Batches = Batches,
+                    .Meshlets = Meshlets,
+                    .Lods = Lods,
+                    .Bounds = Bounds
+            };
+        }
+    };
+
+} // Haus
+
+#endif //HAUS_MESH_H
@@ -0,0 +1,81 @@
+#include "MeshBatcher.h"
+
+namespace Haus {
+    namespace {
+        void NarrowIndices(MeshData &mesh) {
+            mesh.IndexType = IndexFormat::UInt16;
+            mesh.Indices16.assign(mesh.Indices.begin(), mesh.Indices.end());
+        }
+    }
+
+    void MeshBatcher::Build(MeshData &mesh, bool splitLargeMeshes) {
+        mesh.Indices16.clear();
+        mesh.Batches.clear();
+
+        // Meshes without levels of detail are drawn as a single level covering every index
+        if (mesh.Lods.empty())
+            mesh.Lods.push_back({0, static_cast<uint32_t>(mesh.Indices.size()), 0, 0, 0, 0, 0.0f});
+
+        if (mesh.Vertices.size() <= MAX_BATCH_VERTICES || !splitLargeMeshes) {
+            for (MeshLod &lod: mesh.Lods) {
+                lod.FirstBatch = static_cast<uint32_t>(mesh.Batches.size());
+                lod.BatchCount = 1;
+                mesh.Batches.push_back({lod.FirstIndex, lod.IndexCount, 0});
+            }
+
+            if (mesh.Vertices.size() <= MAX_BATCH_VERTICES)
+                NarrowIndices(mesh);
+            else
+                mesh.IndexType = IndexFormat::UInt32;
+
+            return;
+        }
+
+        std::vector<Vertex> vertices;
+        vertices.reserve(mesh.Vertices.size());
+
+        // Local index of every source vertex in the current batch, valid while its stamp matches the batch
+        std::vector<uint32_t> local(mesh.Vertices.size());
+        std::vector<uint32_t> stamps(mesh.Vertices.size(), UINT32_MAX);
+
+        // Levels never share a batch, so every level can be drawn on its own
+        for (MeshLod &lod: mesh.Lods) {
+            lod.FirstBatch = static_cast<uint32_t>(mesh.Batches.size());
+
+            MeshBatch batch{lod.FirstIndex, 0, static_cast<int32_t>(vertices.size())};
+            auto batchIndex = static_cast<uint32_t>(mesh.Batches.size());
+
+            for (size_t t = lod.FirstIndex; t + 2 < lod.FirstIndex + lod.IndexCount; t += 3) {
+                uint32_t newVertices = 0;
+                for (size_t k = 0; k < 3; k++)
+                    newVertices += stamps[mesh.Indices[t + k]] == batchIndex ? 0 : 1;
+
+                if (vertices.size() - batch.VertexOffset + newVertices > MAX_BATCH_VERTICES) {
+                    mesh.Batches.push_back(batch);
+                    batch = {static_cast<uint32_t>(t), 0, static_cast<int32_t>(vertices.size())};
+                    batchIndex++;
+                }
+
+                for (size_t k = 0; k < 3; k++) {
+                    uint32_t &index = mesh.Indices[t + k];
+                    if (stamps[index] != batchIndex) {
+                        stamps[index] = batchIndex;
+                        local[index] = static_cast<uint32_t>(vertices.size() - batch.VertexOffset);
+                        vertices.push_back(mesh.Vertices[index]);
+                    }
+
+                    index = local[index];
+                }
+
+                batch.IndexCount += 3;
+            }
+
+            mesh.Batches.push_back(batch);
+            lod.BatchCount = static_cast<uint32_t>(mesh.Batches.size()) - lod.FirstBatch;
+        }
+
+        mesh.Vertices = std::move(vertices);
+
+        NarrowIndices(mesh);
+    }
+} // Haus
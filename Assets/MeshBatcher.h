@@ -0,0 +1,21 @@
+#ifndef HAUS_MESHBATCHER_H
+#define HAUS_MESHBATCHER_H
+
+#include "Mesh.h"
+
+namespace Haus {
+
+    /* Picks the index width of a mesh. Meshes with at most 65536 vertices get 16-bit indices directly,
+       larger ones are either split into batches that each reference fewer than 65536 vertices (duplicating
+       the vertices shared between batches) or kept as a single 32-bit batch. Levels of detail never share a
+       batch, a mesh without levels gets a single one covering every index. */
+    class MeshBatcher {
+    public:
+        static constexpr size_t MAX_BATCH_VERTICES = 65536;
+
+        static void Build(MeshData &mesh, bool splitLargeMeshes);
+    };
+
+} // Haus
+
+#endif //HAUS_MESHBATCHER_H
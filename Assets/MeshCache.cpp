@@ -0,0 +1,195 @@
+#include "MeshCache.h"
+#include "CacheFile.h"
+#include "Hash.h"
+#include "MeshCodec.h"
+
+#include <cstring>
+
+namespace Haus {
+    namespace {
+        constexpr char MAGIC[4] = {'H', 'M', 'S', 'H'};
+
+        struct MeshCacheHeader {
+            char Magic[4];
+            uint32_t Version;
+            uint64_t Key;
+            VertexPositionFormat PositionFormat;
+            uint32_t Color;
+            uint32_t Deinterleaved;
+            uint32_t VertexStride;
+            uint32_t VertexCount;
+            IndexFormat IndexType;
+            uint32_t IndexCount;
+            uint32_t BatchCount;
+            uint32_t MeshletCount;
+            uint32_t LodCount;
+            uint32_t Compressed;
+            BoundingBox Bounds;
+            VertexQuantization Quantization;
+            uint64_t VertexOffset;
+            uint64_t VertexSize; // Bytes stored in the file, smaller than the geometry when compressed
+            uint64_t IndexOffset;
+            uint64_t IndexSize;
+            uint64_t BatchOffset;
+            uint64_t MeshletOffset;
+            uint64_t LodOffset;
+        };
+
+        uint32_t GetIndexSize(IndexFormat format) {
+            return format == IndexFormat::UInt16 ? sizeof(uint16_t) : sizeof(uint32_t);
+        }
+    }
+
+    std::filesystem::path MeshCache::GetCachePath(const std::filesystem::path &source) {
+        std::filesystem::path path = source;
+        path += ".hmesh";
+        return path;
+    }
+
+    uint64_t MeshCache::ComputeKey(const std::filesystem::path &source, const MeshImportOptions &options) {
+        MappedFile file(source, MappedFileAccess::Sequential);
+
+        uint64_t key = Hash64(file.GetSpan());
+        key = HashCombine(key, options.Hash());
+        return HashCombine(key, VERSION);
+    }
+
+    std::optional<CachedMesh> MeshCache::Load(const std::filesystem::path &cachePath, std::optional<uint64_t> key) {
+        std::error_code error;
+        if (!std::filesystem::is_regular_file(cachePath, error))
+            return std::nullopt;
+
+        CachedMesh mesh{};
+        // Uploaded as a whole right after loading
+        mesh.m_File = MappedFile(cachePath, MappedFileAccess::WillNeed);
+        if (!Parse(mesh, mesh.m_File.GetSpan(), key))
+            return std::nullopt;
+
+        return mesh;
+    }
+
+    std::optional<CachedMesh> MeshCache::Load(const AssetArchive &archive, const std::filesystem::path &cachePath) {
+        const ArchiveEntry *entry = archive.Find(cachePath.generic_string());
+        if (!entry)
+            return std::nullopt;
+
+        CachedMesh mesh{};
+        std::optional<std::span<const std::byte>> file = archive.Read(*entry, mesh.m_Storage);
+        if (!file || !Parse(mesh, *file, std::nullopt))
+            return std::nullopt;
+
+        return mesh;
+    }
+
+    bool MeshCache::Parse(CachedMesh &mesh, std::span<const std::byte> file, std::optional<uint64_t> key) {
+        const std::byte *data = file.data();
+        size_t size = file.size();
+
+        MeshCacheHeader header{};
+        if (size < sizeof(header))
+            return false;
+
+        memcpy(&header, data, sizeof(header));
+
+        VertexLayout layout{
+                .Position = header.PositionFormat,
+                .Color = header.Color != 0,
+                .Deinterleaved = header.Deinterleaved != 0
+        };
+
+        if (memcmp(header.Magic, MAGIC, sizeof(MAGIC)) != 0 || header.Version != VERSION ||
+            (key && header.Key != *key) || header.VertexStride != layout.GetStride())
+            return false;
+
+        uint64_t vertexBytes = static_cast<uint64_t>(header.VertexCount) * header.VertexStride;
+        uint64_t indexBytes = static_cast<uint64_t>(header.IndexCount) * GetIndexSize(header.IndexType);
+        uint64_t batchBytes = static_cast<uint64_t>(header.BatchCount) * sizeof(MeshBatch);
+        uint64_t meshletBytes = static_cast<uint64_t>(header.MeshletCount) * sizeof(Meshlet);
+        uint64_t lodBytes = static_cast<uint64_t>(header.LodCount) * sizeof(MeshLod);
+        if (!CacheFile::InBounds(header.VertexOffset, header.VertexSize, size) ||
+            !CacheFile::InBounds(header.IndexOffset, header.IndexSize, size) ||
+            !CacheFile::InBounds(header.BatchOffset, batchBytes, size) ||
+            !CacheFile::InBounds(header.MeshletOffset, meshletBytes, size) ||
+            !CacheFile::InBounds(header.LodOffset, lodBytes, size))
+            return false;
+
+        mesh.m_View.Layout = layout;
+        mesh.m_View.Quantization = header.Quantization;
+        mesh.m_View.VertexCount = header.VertexCount;
+        std::span<const std::byte> vertexData{data + header.VertexOffset, header.VertexSize};
+        std::span<const std::byte> indexData{data + header.IndexOffset, header.IndexSize};
+
+        if (header.Compressed) {
+            mesh.m_VertexData.resize(vertexBytes);
+            mesh.m_IndexData.resize(indexBytes);
+            if (!MeshCodec::DecodeVertexStreams(vertexData, mesh.m_VertexData, layout, header.VertexCount) ||
+                !MeshCodec::DecodeIndices(indexData, mesh.m_IndexData, header.IndexType))
+                return false;
+
+            vertexData = mesh.m_VertexData;
+            indexData = mesh.m_IndexData;
+        } else if (vertexData.size() != vertexBytes || indexData.size() != indexBytes) {
+            return false;
+        }
+
+        mesh.m_View.VertexData = vertexData;
+        mesh.m_View.IndexType = header.IndexType;
+        mesh.m_View.IndexCount = header.IndexCount;
+        mesh.m_View.IndexData = indexData;
+        mesh.m_View.Batches = {reinterpret_cast<const MeshBatch *>(data + header.BatchOffset), header.BatchCount};
+        mesh.m_View.Meshlets = {reinterpret_cast<const Meshlet *>(data + header.MeshletOffset), header.MeshletCount};
+        mesh.m_View.Lods = {reinterpret_cast<const MeshLod *>(data + header.LodOffset), header.LodCount};
+        mesh.m_View.Bounds = header.Bounds;
+
+        return true;
+    }
+
+    void MeshCache::Store(const std::filesystem::path &cachePath, uint64_t key, const MeshView &mesh, bool compress) {
+        std::vector<std::byte> encodedVertices;
+        std::vector<std::byte> encodedIndices;
+        std::span<const std::byte> vertexData = mesh.VertexData;
+        std::span<const std::byte> indexData = mesh.IndexData;
+
+        if (compress) {
+            encodedVertices = MeshCodec::EncodeVertexStreams(mesh.VertexData, mesh.Layout, mesh.VertexCount);
+            encodedIndices = MeshCodec::EncodeIndices(mesh.IndexData, mesh.IndexType);
+            vertexData = encodedVertices;
+            indexData = encodedIndices;
+        }
+
+        MeshCacheHeader header{
+                .Version = VERSION,
+                .Key = key,
+                .PositionFormat = mesh.Layout.Position,
+                .Color = mesh.Layout.Color ? 1u : 0u,
+                .Deinterleaved = mesh.Layout.Deinterleaved ? 1u : 0u,
+                .VertexStride = mesh.Layout.GetStride(),
+                .VertexCount = mesh.VertexCount,
+                .IndexType = mesh.IndexType,
+                .IndexCount = mesh.IndexCount,
+                .BatchCount = static_cast<uint32_t>(mesh.Batches.size()),
+                .MeshletCount = static_cast<uint32_t>(mesh.Meshlets.size()),
+                .LodCount = static_cast<uint32_t>(mesh.Lods.size()),
+                .Compressed = compress ? 1u : 0u,
+                .Bounds = mesh.Bounds,
+                .Quantization = mesh.Quantization,
+        };
+        memcpy(header.Magic, MAGIC, sizeof(MAGIC));
+        header.VertexOffset = CacheFile::AlignUp(sizeof(header));
+        header.VertexSize = vertexData.size_bytes();
+        header.IndexOffset = CacheFile::AlignUp(header.VertexOffset + header.VertexSize);
+        header.IndexSize = indexData.size_bytes();
+        header.BatchOffset = CacheFile::AlignUp(header.IndexOffset + header.IndexSize);
+        header.MeshletOffset = CacheFile::AlignUp(header.BatchOffset + mesh.Batches.size_bytes());
+        header.LodOffset = CacheFile::AlignUp(header.MeshletOffset + mesh.Meshlets.size_bytes());
+
+        CacheFile::Write(cachePath, [&](std::ofstream &file) {
+            CacheFile::WriteSection(file, 0, std::as_bytes(std::span(&header, 1)));
+            CacheFile::WriteSection(file, header.VertexOffset, vertexData);
+            CacheFile::WriteSection(file, header.IndexOffset, indexData);
+            CacheFile::WriteSection(file, header.BatchOffset, std::as_bytes(mesh.Batches));
+            CacheFile::WriteSection(file, header.MeshletOffset, std::as_bytes(mesh.Meshlets));
+            CacheFile::WriteSection(file, header.LodOffset, std::as_bytes(mesh.Lods));
+        });
+    }
+} // Haus
@@ -0,0 +1,61 @@
+#ifndef HAUS_MESHCACHE_H
+#define HAUS_MESHCACHE_H
+
+#include "AssetArchive.h"
+#include "Mesh.h"
+#include "MappedFile.h"
+#include "MeshImporter.h"
+
+#include <filesystem>
+#include <optional>
+
+namespace Haus {
+
+    /* Mesh whose geometry lives inside a memory-mapped cache file, or an archive entry, the view stays valid for the
+       lifetime of the object and the archive it was loaded from */
+    class CachedMesh {
+    public:
+        const MeshView &View() const {
+            return m_View;
+        }
+
+    private:
+        MappedFile m_File;
+        MeshView m_View;
+        // Decoded geometry of compressed entries, uncompressed ones are used straight from the mapping
+        std::vector<std::byte> m_VertexData;
+        std::vector<std::byte> m_IndexData;
+        // Archive entry that had to be decompressed, stored ones are used straight from the archive's mapping
+        std::vector<std::byte> m_Storage;
+
+        friend class MeshCache;
+    };
+
+    /* Binary cache of imported meshes, stored next to the source as "<source>.hmesh".
+       Entries are keyed by a hash of the source bytes, the import options and the cache version,
+       so a stale or foreign file is simply treated as a miss and rewritten. Entries may store their vertices
+       and indices with MeshCodec, which trades a decode on load for much less to read. */
+    class MeshCache {
+    public:
+        static constexpr uint32_t VERSION = 9;
+
+        static std::filesystem::path GetCachePath(const std::filesystem::path &source);
+
+        static uint64_t ComputeKey(const std::filesystem::path &source, const MeshImportOptions &options);
+
+        // Without a key any entry of the current version is accepted, for baked assets shipped without their source
+        static std::optional<CachedMesh> Load(const std::filesystem::path &cachePath, std::optional<uint64_t> key);
+
+        // Baked entry packed into an archive, named by its cache path
+        static std::optional<CachedMesh> Load(const AssetArchive &archive, const std::filesystem::path &cachePath);
+
+        static void Store(const std::filesystem::path &cachePath, uint64_t key, const MeshView &mesh,
+                          bool compress = false);
+
+    private:
+        static bool Parse(CachedMesh &mesh, std::span<const std::byte> file, std::optional<uint64_t> key);
+    };
+
+} // Haus
+
+#endif //HAUS_MESHCACHE_H
@@ -0,0 +1,463 @@
+#include "MeshCodec.h"
+
+#include <array>
+#include <cstring>
+
+namespace Haus {
+    namespace {
+        constexpr uint8_t VERTEX_CODEC_VERSION = 1;
+        constexpr uint8_t INDEX_CODEC_VERSION = 1;
+
+        constexpr size_t BLOCK_VERTICES = 256;
+        constexpr size_t GROUP_SIZE = 16;
+        constexpr size_t GROUPS_PER_BLOCK = BLOCK_VERTICES / GROUP_SIZE;
+        constexpr uint32_t GROUP_BITS[4] = {0, 2, 4, 8};
+
+        // Edge FIFO hits use the high nibble of the triangle code, 0xF0 and up start a triangle without one
+        constexpr uint32_t EDGE_FIFO_SIZE = 16;
+        constexpr uint32_t EDGE_FIFO_CODES = 15;
+        // Vertex codes: 0 is the next unseen vertex, 1 to 14 the vertex FIFO, 15 an explicit delta
+        constexpr uint32_t VERTEX_FIFO_SIZE = 16;
+        constexpr uint32_t VERTEX_FIFO_CODES = 14;
+        constexpr uint8_t VERTEX_NEXT = 0;
+        constexpr uint8_t VERTEX_EXPLICIT = 15;
+        constexpr uint8_t TRIANGLE_NO_EDGE = 0xF0;
+
+        uint8_t ZigZag(uint8_t delta) {
+            return static_cast<uint8_t>((delta << 1) ^ static_cast<uint8_t>(static_cast<int8_t>(delta) >> 7));
+        }
+
+        uint8_t UnZigZag(uint8_t value) {
+            return static_cast<uint8_t>((value >> 1) ^ -(value & 1));
+        }
+
+        // Writes 16 values of the given width, lowest bits first
+        void PackGroup(const uint8_t *values, uint32_t bits, std::vector<std::byte> &output) {
+            if (bits == 0)
+                return;
+
+            uint32_t perByte = 8 / bits;
+            for (size_t i = 0; i < GROUP_SIZE; i += perByte) {
+                uint32_t byte = 0;
+                for (uint32_t k = 0; k < perByte; k++)
+                    byte |= static_cast<uint32_t>(values[i + k]) << (k * bits);
+
+                output.push_back(static_cast<std::byte>(byte));
+            }
+        }
+
+        void UnpackGroup(const uint8_t *input, uint32_t bits, uint8_t *values) {
+            switch (bits) {
+                case 0:
+                    memset(values, 0, GROUP_SIZE);
+                    break;
+                case 2:
+                    for (size_t i = 0; i < GROUP_SIZE; i++)
+                        values[i] = (input[i / 4] >> ((i % 4) * 2)) & 3;
+                    break;
+                case 4:
+                    for (size_t i = 0; i < GROUP_SIZE; i++)
+                        values[i] = (input[i / 2] >> ((i % 2) * 4)) & 15;
+                    break;
+                default:
+                    memcpy(values, input, GROUP_SIZE);
+                    break;
+            }
+        }
+
+        class IndexReader {
+        public:
+            IndexReader(std::span<const std::byte> indices, IndexFormat format) : m_Data(indices), m_Format(format) {}
+
+            size_t Size() const {
+                return m_Data.size() / (m_Format == IndexFormat::UInt16 ? sizeof(uint16_t) : sizeof(uint32_t));
+            }
+
+            uint32_t operator[](size_t i) const {
+                if (m_Format == IndexFormat::UInt16) {
+                    uint16_t value;
+                    memcpy(&value, m_Data.data() + i * sizeof(value), sizeof(value));
+                    return value;
+                }
+
+                uint32_t value;
+                memcpy(&value, m_Data.data() + i * sizeof(value), sizeof(value));
+                return value;
+            }
+
+        private:
+            std::span<const std::byte> m_Data;
+            IndexFormat m_Format;
+        };
+
+        struct Edge {
+            uint32_t A;
+            uint32_t B;
+        };
+
+        // Most recent entry first, stale slots hold UINT32_MAX which never matches a real index
+        template<typename T, uint32_t Size>
+        struct Fifo {
+            std::array<T, Size> Entries;
+            uint32_t Head = 0;
+
+            explicit Fifo(T empty) {
+                Entries.fill(empty);
+            }
+
+            const T &Get(uint32_t age) const {
+                return Entries[(Head - 1 - age) & (Size - 1)];
+            }
+
+            void Push(const T &value) {
+                Entries[Head++ & (Size - 1)] = value;
+            }
+        };
+
+        void WriteVarint(uint32_t value, std::vector<std::byte> &output) {
+            while (value >= 0x80) {
+                output.push_back(static_cast<std::byte>((value & 0x7F) | 0x80));
+                value >>= 7;
+            }
+            output.push_back(static_cast<std::byte>(value));
+        }
+
+        bool ReadVarint(const uint8_t *&p, const uint8_t *end, uint32_t &value) {
+            value = 0;
+            for (uint32_t shift = 0; shift < 35; shift += 7) {
+                if (p == end)
+                    return false;
+
+                uint8_t byte = *p++;
+                value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+                if (!(byte & 0x80))
+                    return true;
+            }
+            return false;
+        }
+
+        // Explicit vertices are coded as a zigzag delta to the previous explicit one
+        void WriteExplicit(uint32_t vertex, uint32_t &last, std::vector<std::byte> &output) {
+            auto delta = static_cast<int32_t>(vertex - last);
+            WriteVarint(static_cast<uint32_t>((delta << 1) ^ (delta >> 31)), output);
+            last = vertex;
+        }
+
+        bool ReadExplicit(const uint8_t *&p, const uint8_t *end, uint32_t &last, uint32_t &vertex) {
+            uint32_t value;
+            if (!ReadVarint(p, end, value))
+                return false;
+
+            last += (value >> 1) ^ -(value & 1);
+            vertex = last;
+            return true;
+        }
+    }
+
+    std::vector<std::byte> MeshCodec::EncodeVertices(std::span<const std::byte> vertices, size_t vertexStride) {
+        size_t vertexCount = vertices.size() / vertexStride;
+
+        std::vector<std::byte> output;
+        output.reserve(vertices.size() / 2 + 16);
+        output.push_back(static_cast<std::byte>(VERTEX_CODEC_VERSION));
+        WriteVarint(static_cast<uint32_t>(vertexCount), output);
+
+        const auto *data = reinterpret_cast<const uint8_t *>(vertices.data());
+        std::vector<uint8_t> previous(vertexStride, 0);
+        uint8_t lane[BLOCK_VERTICES];
+
+        for (size_t first = 0; first < vertexCount; first += BLOCK_VERTICES) {
+            size_t count = std::min(BLOCK_VERTICES, vertexCount - first);
+            size_t groups = (count + GROUP_SIZE - 1) / GROUP_SIZE;
+
+            for (size_t k = 0; k < vertexStride; k++) {
+                uint8_t last = previous[k];
+                for (size_t i = 0; i < groups * GROUP_SIZE; i++) {
+                    uint8_t value = i < count ? data[(first + i) * vertexStride + k] : last;
+                    lane[i] = ZigZag(static_cast<uint8_t>(value - last));
+                    last = value;
+                }
+                previous[k] = data[(first + count - 1) * vertexStride + k];
+
+                // Two bits of width per group, then the packed groups
+                uint32_t header = 0;
+                uint32_t widths[GROUPS_PER_BLOCK];
+                for (size_t g = 0; g < groups; g++) {
+                    uint8_t largest = 0;
+                    for (size_t i = 0; i < GROUP_SIZE; i++)
+                        largest = std::max(largest, lane[g * GROUP_SIZE + i]);
+
+                    uint32_t width = largest == 0 ? 0 : largest < 4 ? 1 : largest < 16 ? 2 : 3;
+                    widths[g] = width;
+                    header |= width << (g * 2);
+                }
+
+                for (size_t b = 0; b < (groups * 2 + 7) / 8; b++)
+                    output.push_back(static_cast<std::byte>(header >> (b * 8)));
+
+                for (size_t g = 0; g < groups; g++)
+                    PackGroup(&lane[g * GROUP_SIZE], GROUP_BITS[widths[g]], output);
+            }
+        }
+
+        return output;
+    }
+
+    bool MeshCodec::DecodeVertices(std::span<const std::byte> encoded, std::span<std::byte> vertices,
+                                   size_t vertexStride) {
+        const auto *p = reinterpret_cast<const uint8_t *>(encoded.data());
+        const uint8_t *end = p + encoded.size();
+
+        uint32_t vertexCount;
+        if (p == end || *p++ != VERTEX_CODEC_VERSION || !ReadVarint(p, end, vertexCount) ||
+            static_cast<uint64_t>(vertexCount) * vertexStride != vertices.size())
+            return false;
+
+        auto *data = reinterpret_cast<uint8_t *>(vertices.data());
+        std::vector<uint8_t> previous(vertexStride, 0);
+        uint8_t lane[BLOCK_VERTICES];
+
+        for (size_t first = 0; first < vertexCount; first += BLOCK_VERTICES) {
+            size_t count = std::min(BLOCK_VERTICES, vertexCount - first);
+            size_t groups = (count + GROUP_SIZE - 1) / GROUP_SIZE;
+            size_t headerBytes = (groups * 2 + 7) / 8;
+
+            for (size_t k = 0; k < vertexStride; k++) {
+                if (static_cast<size_t>(end - p) < headerBytes)
+                    return false;
+
+                uint32_t header = 0;
+                for (size_t b = 0; b < headerBytes; b++)
+                    header |= static_cast<uint32_t>(*p++) << (b * 8);
+
+                for (size_t g = 0; g < groups; g++) {
+                    uint32_t bits = GROUP_BITS[(header >> (g * 2)) & 3];
+                    size_t size = GROUP_SIZE * bits / 8;
+                    if (static_cast<size_t>(end - p) < size)
+                        return false;
+
+                    UnpackGroup(p, bits, &lane[g * GROUP_SIZE]);
+                    p += size;
+                }
+
+                uint8_t last = previous[k];
+                for (size_t i = 0; i < count; i++) {
+                    last = static_cast<uint8_t>(last + UnZigZag(lane[i]));
+                    data[(first + i) * vertexStride + k] = last;
+                }
+                previous[k] = last;
+            }
+        }
+
+        return p == end;
+    }
+
+    std::vector<std::byte> MeshCodec::EncodeVertexStreams(std::span<const std::byte> vertices,
+                                                          const VertexLayout &layout, uint32_t vertexCount) {
+        std::vector<std::byte> output;
+        for (uint32_t stream = 0; stream < layout.GetStreamCount(); stream++) {
+            size_t stride = layout.GetStreamStride(stream);
+            std::vector<std::byte> encoded = EncodeVertices(
+                    vertices.subspan(layout.GetStreamOffset(stream, vertexCount), stride * vertexCount), stride);
+
+            WriteVarint(static_cast<uint32_t>(encoded.size()), output);
+            output.insert(output.end(), encoded.begin(), encoded.end());
+        }
+
+        return output;
+    }
+
+    bool MeshCodec::DecodeVertexStreams(std::span<const std::byte> encoded, std::span<std::byte> vertices,
+                                        const VertexLayout &layout, uint32_t vertexCount) {
+        if (static_cast<uint64_t>(layout.GetStride()) * vertexCount != vertices.size())
+            return false;
+
+        const auto *p = reinterpret_cast<const uint8_t *>(encoded.data());
+        const uint8_t *end = p + encoded.size();
+
+        for (uint32_t stream = 0; stream < layout.GetStreamCount(); stream++) {
+            uint32_t size;
+            if (!ReadVarint(p, end, size) || static_cast<size_t>(end - p) < size)
+                return false;
+
+            size_t stride = layout.GetStreamStride(stream);
+            std::span<std::byte> output = vertices.subspan(layout.GetStreamOffset(stream, vertexCount),
+                                                           stride * vertexCount);
+            if (!DecodeVertices({reinterpret_cast<const std::byte *>(p), size}, output, stride))
+                return false;
+
+            p += size;
+        }
+
+        return p == end;
+    }
+
+    std::vector<std::byte> MeshCodec::EncodeIndices(std::span<const std::byte> indices, IndexFormat format) {
+        IndexReader reader(indices, format);
+        size_t indexCount = reader.Size() / 3 * 3;
+
+        std::vector<std::byte> output;
+        output.reserve(indexCount / 2 + 16);
+        output.push_back(static_cast<std::byte>(INDEX_CODEC_VERSION));
+        WriteVarint(static_cast<uint32_t>(indexCount), output);
+
+        Fifo<Edge, EDGE_FIFO_SIZE> edges({UINT32_MAX, UINT32_MAX});
+        Fifo<uint32_t, VERTEX_FIFO_SIZE> fifo(UINT32_MAX);
+        uint32_t next = 0;
+        uint32_t last = 0;
+
+        auto encodeVertex = [&](uint32_t vertex) -> uint8_t {
+            if (vertex == next) {
+                next++;
+                fifo.Push(vertex);
+                return VERTEX_NEXT;
+            }
+
+            for (uint32_t age = 0; age < VERTEX_FIFO_CODES; age++) {
+                if (fifo.Get(age) == vertex)
+                    return static_cast<uint8_t>(age + 1);
+            }
+
+            fifo.Push(vertex);
+            return VERTEX_EXPLICIT;
+        };
+
+        for (size_t t = 0; t < indexCount; t += 3) {
+            uint32_t corners[3] = {reader[t], reader[t + 1], reader[t + 2]};
+
+            // A recent edge (a, b) is shared by this triangle as (b, a), rotate the triangle to start with it
+            int32_t edgeAge = -1;
+            for (uint32_t age = 0; age < EDGE_FIFO_CODES && edgeAge < 0; age++) {
+                const Edge &edge = edges.Get(age);
+                for (uint32_t rotation = 0; rotation < 3; rotation++) {
+                    if (corners[rotation] == edge.B && corners[(rotation + 1) % 3] == edge.A) {
+                        uint32_t rotated[3] = {corners[rotation], corners[(rotation + 1) % 3], corners[(rotation + 2) % 3]};
+                        memcpy(corners, rotated, sizeof(corners));
+                        edgeAge = static_cast<int32_t>(age);
+                        break;
+                    }
+                }
+            }
+
+            auto [a, b, c] = corners;
+
+            if (edgeAge >= 0) {
+                uint8_t code = encodeVertex(c);
+                output.push_back(static_cast<std::byte>((edgeAge << 4) | code));
+                if (code == VERTEX_EXPLICIT)
+                    WriteExplicit(c, last, output);
+
+                edges.Push({b, c});
+                edges.Push({c, a});
+                continue;
+            }
+
+            uint8_t codes[3] = {encodeVertex(a), encodeVertex(b), encodeVertex(c)};
+            output.push_back(static_cast<std::byte>(TRIANGLE_NO_EDGE | codes[0]));
+            output.push_back(static_cast<std::byte>((codes[1] << 4) | codes[2]));
+            for (uint32_t k = 0; k < 3; k++) {
+                if (codes[k] == VERTEX_EXPLICIT)
+                    WriteExplicit(corners[k], last, output);
+            }
+
+            edges.Push({a, b});
+            edges.Push({b, c});
+            edges.Push({c, a});
+        }
+
+        return output;
+    }
+
+    bool MeshCodec::DecodeIndices(std::span<const std::byte> encoded, std::span<std::byte> indices,
+                                  IndexFormat format) {
+        const auto *p = reinterpret_cast<const uint8_t *>(encoded.data());
+        const uint8_t *end = p + encoded.size();
+        size_t indexSize = format == IndexFormat::UInt16 ? sizeof(uint16_t) : sizeof(uint32_t);
+
+        uint32_t indexCount;
+        if (p == end || *p++ != INDEX_CODEC_VERSION || !ReadVarint(p, end, indexCount) ||
+            static_cast<uint64_t>(indexCount) * indexSize != indices.size() || indexCount % 3 != 0)
+            return false;
+
+        Fifo<Edge, EDGE_FIFO_SIZE> edges({UINT32_MAX, UINT32_MAX});
+        Fifo<uint32_t, VERTEX_FIFO_SIZE> fifo(UINT32_MAX);
+        uint32_t next = 0;
+        uint32_t last = 0;
+
+        // Explicit deltas follow the triangle codes in corner order, so they are read as the corners are decoded
+        auto decodeVertex = [&](uint8_t code, uint32_t &vertex) {
+            if (code == VERTEX_NEXT) {
+                vertex = next++;
+                fifo.Push(vertex);
+                return true;
+            }
+
+            if (code == VERTEX_EXPLICIT) {
+                if (!ReadExplicit(p, end, last, vertex))
+                    return false;
+
+                fifo.Push(vertex);
+                return true;
+            }
+
+            vertex = fifo.Get(code - 1);
+            return vertex != UINT32_MAX;
+        };
+
+        auto *output = reinterpret_cast<uint8_t *>(indices.data());
+        auto write = [&](size_t i, uint32_t value) {
+            if (format == IndexFormat::UInt16) {
+                auto narrow = static_cast<uint16_t>(value);
+                memcpy(output + i * sizeof(narrow), &narrow, sizeof(narrow));
+            } else {
+                memcpy(output + i * sizeof(value), &value, sizeof(value));
+            }
+        };
+
+        for (size_t t = 0; t < indexCount; t += 3) {
+            if (p == end)
+                return false;
+
+            uint8_t code = *p++;
+            uint32_t a, b, c;
+
+            if (code < TRIANGLE_NO_EDGE) {
+                const Edge &edge = edges.Get(code >> 4);
+                a = edge.B;
+                b = edge.A;
+                if (a == UINT32_MAX || !decodeVertex(code & 15, c))
+                    return false;
+
+                edges.Push({b, c});
+                edges.Push({c, a});
+            } else {
+                if (p == end)
+                    return false;
+
+                uint8_t codes[3] = {static_cast<uint8_t>(code & 15), static_cast<uint8_t>(*p >> 4),
+                                    static_cast<uint8_t>(*p & 15)};
+                p++;
+
+                uint32_t corners[3];
+                for (uint32_t k = 0; k < 3; k++) {
+                    if (!decodeVertex(codes[k], corners[k]))
+                        return false;
+                }
+
+                a = corners[0];
+                b = corners[1];
+                c = corners[2];
+
+                edges.Push({a, b});
+                edges.Push({b, c});
+                edges.Push({c, a});
+            }
+
+            write(t + 0, a);
+            write(t + 1, b);
+            write(t + 2, c);
+        }
+
+        return p == end;
+    }
+} // Haus
@@ -0,0 +1,40 @@
+#ifndef HAUS_MESHCODEC_H
+#define HAUS_MESHCODEC_H
+
+#include "Mesh.h"
+
+namespace Haus {
+
+    /* Lossless compression of GPU-ready geometry, to be used on top of the quantized vertex layouts.
+
+       Vertices are split into blocks, every byte of the vertex is delta coded against the previous vertex,
+       zigzag mapped and stored byte-lane transposed in groups of 16 packed to 0, 2, 4 or 8 bits. Decoding a
+       group is a fixed unpack followed by a prefix sum, which compilers turn into vector code.
+
+       Triangles are coded against a FIFO of recently seen edges and one of recently seen vertices, so a
+       triangle sharing an edge with a recent one usually costs a single byte. Triangles may come back rotated
+       (same winding, different first corner), which leaves every draw range unchanged. */
+    class MeshCodec {
+    public:
+        static std::vector<std::byte> EncodeVertices(std::span<const std::byte> vertices, size_t vertexStride);
+
+        // Returns false on malformed input, vertices must hold exactly the encoded vertex count times the stride
+        static bool DecodeVertices(std::span<const std::byte> encoded, std::span<std::byte> vertices,
+                                   size_t vertexStride);
+
+        // Codes every stream of the layout on its own, each prefixed with its encoded size
+        static std::vector<std::byte> EncodeVertexStreams(std::span<const std::byte> vertices, const VertexLayout &layout,
+                                                          uint32_t vertexCount);
+
+        static bool DecodeVertexStreams(std::span<const std::byte> encoded, std::span<std::byte> vertices,
+                                        const VertexLayout &layout, uint32_t vertexCount);
+
+        static std::vector<std::byte> EncodeIndices(std::span<const std::byte> indices, IndexFormat format);
+
+        // Returns false on malformed input, indices must hold exactly the encoded index count
+        static bool DecodeIndices(std::span<const std::byte> encoded, std::span<std::byte> indices, IndexFormat format);
+    };
+
+} // Haus
+
+#endif //HAUS_MESHCODEC_H
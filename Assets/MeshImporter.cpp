@@ -0,0 +1,106 @@
+#include "MeshImporter.h"
+#include "Hash.h"
+#include "MappedFile.h"
+#include "MeshBatcher.h"
+#include "MeshletBuilder.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "ObjParser.h"
+#include "TangentGenerator.h"
+#include "VertexWelder.h"
+
+namespace Haus {
+    uint64_t MeshImportOptions::Hash() const {
+        uint64_t hash = Hash64(&DefaultColor, sizeof(DefaultColor));
+        hash = HashCombine(hash, Optimize ? 1 : 0);
+        hash = HashCombine(hash, static_cast<uint64_t>(Layout.Position));
+        hash = HashCombine(hash, Layout.Color ? 1 : 0);
+        hash = HashCombine(hash, Layout.Deinterleaved ? 1 : 0);
+        hash = HashCombine(hash, SplitLargeMeshes ? 1 : 0);
+        hash = HashCombine(hash, GenerateMeshlets ? 1 : 0);
+        hash = HashCombine(hash, LodCount);
+        return HashCombine(hash, Hash64(&LodReduction, sizeof(LodReduction)));
+    }
+
+    MeshData MeshImporter::ImportObj(const std::filesystem::path &path, const MeshImportOptions &options,
+                                     ThreadPool *pool, MeshImportStats *stats) {
+        MeshData mesh{};
+        mesh.Bounds = {glm::vec3(std::numeric_limits<float>::max()), glm::vec3(std::numeric_limits<float>::lowest())};
+
+        VertexWelder welder;
+
+        auto weld = [&](const ObjData &obj, std::span<const ObjIndex> corners) {
+            for (const auto &index: corners) {
+                Vertex vertex{};
+                vertex.Position = {
+                        obj.Positions[3 * index.Position + 0],
+                        obj.Positions[3 * index.Position + 1],
+                        obj.Positions[3 * index.Position + 2],
+                };
+
+                if (index.Normal >= 0) {
+                    vertex.Normal = {
+                            obj.Normals[3 * index.Normal + 0],
+                            obj.Normals[3 * index.Normal + 1],
+                            obj.Normals[3 * index.Normal + 2],
+                    };
+                }
+
+                if (index.TextureCoord >= 0) {
+                    vertex.TextureCoord = {
+                            obj.TextureCoords[2 * index.TextureCoord + 0],
+                            obj.TextureCoords[2 * index.TextureCoord + 1],
+                    };
+                }
+
+                vertex.Color = options.DefaultColor;
+
+                mesh.Indices.push_back(welder.Weld(vertex));
+            }
+        };
+
+        if (std::filesystem::file_size(path) > options.StreamingThreshold) {
+            ObjParser::ParseStream(path, weld);
+        } else {
+            // Chunks are parsed in parallel, so the whole file is read ahead rather than front to back
+            MappedFile file(path, MappedFileAccess::WillNeed);
+            ObjData obj = ObjParser::Parse(file.GetSpan(), pool);
+
+            // Roughly one welded vertex per position, seams add a few more and the table grows if needed
+            welder = VertexWelder(obj.Positions.size() / 3);
+            mesh.Indices.reserve(obj.Corners.size());
+
+            weld(obj, obj.Corners);
+        }
+
+        if (stats)
+            stats->Weld = welder.GetStats();
+
+        mesh.Vertices = welder.TakeVertices();
+        for (const Vertex &vertex: mesh.Vertices) {
+            mesh.Bounds.Min = glm::min(mesh.Bounds.Min, vertex.Position);
+            mesh.Bounds.Max = glm::max(mesh.Bounds.Max, vertex.Position);
+        }
+
+        TangentGenerator::Generate(mesh);
+
+        if (options.Optimize) {
+            MeshOptimizerStats vertexCache = MeshOptimizer::Optimize(mesh);
+            if (stats)
+                stats->VertexCache = vertexCache;
+        }
+
+        if (options.LodCount > 1)
+            MeshSimplifier::BuildLods(mesh, options.LodCount, options.LodReduction);
+
+        MeshBatcher::Build(mesh, options.SplitLargeMeshes);
+
+        if (options.GenerateMeshlets)
+            MeshletBuilder::Build(mesh);
+
+        mesh.Layout = options.Layout;
+        mesh.Packed = VertexPacker::Pack(mesh.Vertices, mesh.Layout);
+
+        return mesh;
+    }
+} // Haus
@@ -0,0 +1,50 @@
+#ifndef HAUS_MESHIMPORTER_H
+#define HAUS_MESHIMPORTER_H
+
+#include "Mesh.h"
+#include "MeshOptimizer.h"
+#include "ThreadPool.h"
+#include "VertexWelder.h"
+
+#include <filesystem>
+
+namespace Haus {
+
+    // Everything that changes the imported result, so it can take part in the cache key
+    struct MeshImportOptions {
+        /* Files larger than this are parsed in a single pass over fixed-size windows and welded while reading
+           instead of parsing the mapped file on all threads first. Slower, but neither the corner list nor the
+           whole file is ever held. The positions, texture coordinates and normals still grow with the file, since a
+           face may refer back to any of them, so peak memory is the final mesh plus those attribute arrays. The
+           result is identical, so it is not part of the hash. */
+        uint64_t StreamingThreshold = UINT64_MAX;
+        glm::vec3 DefaultColor{1.0f, 1.0f, 1.0f};
+        // Reorder triangles and vertices for the post-transform cache, overdraw and vertex fetch
+        bool Optimize = false;
+        VertexLayout Layout;
+        // Split meshes above 65536 vertices into 16-bit batches instead of falling back to 32-bit indices
+        bool SplitLargeMeshes = true;
+        bool GenerateMeshlets = false;
+        // Levels of detail including the full mesh, each one keeps LodReduction of the previous triangle count
+        uint32_t LodCount = 1;
+        float LodReduction = 0.5f;
+
+        uint64_t Hash() const;
+    };
+
+    // How the import went, for tools to report
+    struct MeshImportStats {
+        VertexWelderStats Weld;
+        // Only filled in when the options ask for Optimize
+        MeshOptimizerStats VertexCache;
+    };
+
+    class MeshImporter {
+    public:
+        static MeshData ImportObj(const std::filesystem::path &path, const MeshImportOptions &options,
+                                  ThreadPool *pool = nullptr, MeshImportStats *stats = nullptr);
+    };
+
+} // Haus
+
+#endif //HAUS_MESHIMPORTER_H
@@ -0,0 +1,292 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace Haus {
+    namespace {
+        // Cluster boundaries are only placed where the cluster so far is at most this much worse than the whole mesh
+        constexpr float OVERDRAW_SPLIT_THRESHOLD = 1.05f;
+
+        // Triangles adjacent to every vertex in compressed row form
+        struct TriangleAdjacency {
+            std::vector<uint32_t> Offsets;
+            std::vector<uint32_t> Triangles;
+
+            TriangleAdjacency(std::span<const uint32_t> indices, size_t vertexCount) : Offsets(vertexCount + 1, 0) {
+                for (uint32_t index: indices)
+                    Offsets[index + 1]++;
+
+                std::partial_sum(Offsets.begin(), Offsets.end(), Offsets.begin());
+
+                std::vector<uint32_t> cursor(Offsets.begin(), Offsets.end() - 1);
+                Triangles.resize(indices.size());
+                for (size_t i = 0; i < indices.size(); i++)
+                    Triangles[cursor[indices[i]]++] = static_cast<uint32_t>(i / 3);
+            }
+        };
+
+        // FIFO cache simulation based on timestamps, a vertex is cached while fewer than cacheSize misses happened since
+        class FifoCache {
+        public:
+            FifoCache(size_t vertexCount, uint32_t cacheSize) : m_Stamps(vertexCount, 0), m_Size(cacheSize) {}
+
+            bool Access(uint32_t vertex) {
+                if (m_Time - m_Stamps[vertex] < m_Size)
+                    return true;
+
+                m_Stamps[vertex] = ++m_Time;
+                return false;
+            }
+
+        private:
+            std::vector<uint64_t> m_Stamps;
+            uint64_t m_Time = UINT32_MAX;
+            uint32_t m_Size;
+        };
+    }
+
+    VertexCacheStats MeshOptimizer::AnalyzeVertexCache(std::span<const uint32_t> indices, size_t vertexCount,
+                                                       uint32_t cacheSize) {
+        FifoCache cache(vertexCount, cacheSize);
+        std::vector<bool> referenced(vertexCount, false);
+
+        size_t misses = 0;
+        size_t referencedCount = 0;
+        for (uint32_t index: indices) {
+            misses += cache.Access(index) ? 0 : 1;
+
+            if (!referenced[index]) {
+                referenced[index] = true;
+                referencedCount++;
+            }
+        }
+
+        size_t triangleCount = indices.size() / 3;
+        return {
+                triangleCount ? static_cast<float>(misses) / static_cast<float>(triangleCount) : 0.0f,
+                referencedCount ? static_cast<float>(misses) / static_cast<float>(referencedCount) : 0.0f,
+        };
+    }
+
+    void MeshOptimizer::OptimizeVertexCache(std::span<uint32_t> indices, size_t vertexCount, uint32_t cacheSize,
+                                            std::vector<uint32_t> *clusters) {
+        size_t triangleCount = indices.size() / 3;
+        if (triangleCount == 0)
+            return;
+
+        TriangleAdjacency adjacency(indices, vertexCount);
+
+        std::vector<uint32_t> liveTriangles(vertexCount);
+        for (size_t v = 0; v < vertexCount; v++)
+            liveTriangles[v] = adjacency.Offsets[v + 1] - adjacency.Offsets[v];
+
+        std::vector<uint32_t> cacheStamps(vertexCount, 0);
+        std::vector<bool> emitted(triangleCount, false);
+        std::vector<uint32_t> deadEnds;
+        std::vector<uint32_t> candidates;
+
+        std::vector<uint32_t> result;
+        result.reserve(indices.size());
+
+        std::vector<uint32_t> hardBoundaries;
+
+        uint32_t time = cacheSize + 1;
+        size_t cursor = 0;
+        int64_t fanning = 0;
+
+        while (fanning >= 0) {
+            candidates.clear();
+
+            auto vertex = static_cast<uint32_t>(fanning);
+            for (uint32_t a = adjacency.Offsets[vertex]; a < adjacency.Offsets[vertex + 1]; a++) {
+                uint32_t triangle = adjacency.Triangles[a];
+                if (emitted[triangle])
+                    continue;
+
+                for (int k = 0; k < 3; k++) {
+                    uint32_t v = indices[triangle * 3 + k];
+                    result.push_back(v);
+                    deadEnds.push_back(v);
+                    candidates.push_back(v);
+                    liveTriangles[v]--;
+
+                    if (time - cacheStamps[v] > cacheSize)
+                        cacheStamps[v] = time++;
+                }
+
+                emitted[triangle] = true;
+            }
+
+            // Prefer the candidate that is still in cache and has the fewest live triangles left
+            int64_t best = -1;
+            int64_t bestPriority = -1;
+            for (uint32_t v: candidates) {
+                if (liveTriangles[v] == 0)
+                    continue;
+
+                int64_t priority = 0;
+                if (time - cacheStamps[v] + 2 * liveTriangles[v] <= cacheSize)
+                    priority = time - cacheStamps[v];
+
+                if (priority > bestPriority) {
+                    best = v;
+                    bestPriority = priority;
+                }
+            }
+
+            if (best < 0) {
+                // Dead end, fall back to recently used vertices and then to the next unprocessed vertex
+                while (!deadEnds.empty() && best < 0) {
+                    uint32_t v = deadEnds.back();
+                    deadEnds.pop_back();
+                    if (liveTriangles[v] > 0)
+                        best = v;
+                }
+
+                while (best < 0 && cursor < vertexCount) {
+                    if (liveTriangles[cursor] > 0) {
+                        best = static_cast<int64_t>(cursor);
+                        hardBoundaries.push_back(static_cast<uint32_t>(result.size() / 3));
+                    }
+                    cursor++;
+                }
+            }
+
+            fanning = best;
+        }
+
+        if (clusters) {
+            // Split where the cache restarts and the cluster so far is not notably worse than the whole mesh
+            float targetAcmr = AnalyzeVertexCache(result, vertexCount, cacheSize).ACMR;
+
+            FifoCache cache(vertexCount, cacheSize);
+            size_t boundary = 0;
+            size_t clusterStart = 0;
+            size_t clusterMisses = 0;
+
+            clusters->assign(1, 0);
+            for (size_t t = 0; t < triangleCount; t++) {
+                int misses = 0;
+                for (int k = 0; k < 3; k++)
+                    misses += cache.Access(result[t * 3 + k]) ? 0 : 1;
+
+                bool hardBoundary = boundary < hardBoundaries.size() && hardBoundaries[boundary] == t;
+                if (hardBoundary)
+                    boundary++;
+
+                size_t clusterSize = t - clusterStart;
+                if (t > 0 && (hardBoundary || (misses == 3 && clusterSize > 0 &&
+                                               static_cast<float>(clusterMisses) / static_cast<float>(clusterSize) <=
+                                               OVERDRAW_SPLIT_THRESHOLD * targetAcmr))) {
+                    clusters->push_back(static_cast<uint32_t>(t));
+                    clusterStart = t;
+                    clusterMisses = 0;
+                }
+
+                clusterMisses += misses;
+            }
+        }
+
+        std::ranges::copy(result, indices.begin());
+    }
+
+    void MeshOptimizer::OptimizeOverdraw(std::span<uint32_t> indices, std::span<const Vertex> vertices,
+                                         std::span<const uint32_t> clusters) {
+        size_t triangleCount = indices.size() / 3;
+        if (clusters.size() < 2)
+            return;
+
+        glm::vec3 meshCentroid{0.0f};
+        float meshArea = 0.0f;
+
+        struct Cluster {
+            uint32_t First;
+            uint32_t Count;
+            glm::vec3 Centroid;
+            glm::vec3 Normal;
+            float Sort;
+        };
+
+        std::vector<Cluster> sorted(clusters.size());
+        for (size_t c = 0; c < clusters.size(); c++) {
+            Cluster &cluster = sorted[c];
+            cluster.First = clusters[c];
+            cluster.Count = static_cast<uint32_t>((c + 1 < clusters.size() ? clusters[c + 1] : triangleCount) -
+                                                  clusters[c]);
+            cluster.Centroid = glm::vec3(0.0f);
+            cluster.Normal = glm::vec3(0.0f);
+
+            float clusterArea = 0.0f;
+            for (uint32_t t = cluster.First; t < cluster.First + cluster.Count; t++) {
+                const glm::vec3 &a = vertices[indices[t * 3 + 0]].Position;
+                const glm::vec3 &b = vertices[indices[t * 3 + 1]].Position;
+                const glm::vec3 &p = vertices[indices[t * 3 + 2]].Position;
+
+                glm::vec3 normal = glm::cross(b - a, p - a);
+                float area = glm::length(normal);
+
+                cluster.Centroid += (a + b + p) * (area / 3.0f);
+                cluster.Normal += normal;
+                clusterArea += area;
+            }
+
+            meshCentroid += cluster.Centroid;
+            meshArea += clusterArea;
+
+            if (clusterArea > 0.0f)
+                cluster.Centroid /= clusterArea;
+
+            float normalLength = glm::length(cluster.Normal);
+            if (normalLength > 0.0f)
+                cluster.Normal /= normalLength;
+        }
+
+        if (meshArea > 0.0f)
+            meshCentroid /= meshArea;
+
+        for (Cluster &cluster: sorted)
+            cluster.Sort = glm::dot(cluster.Centroid - meshCentroid, cluster.Normal);
+
+        std::ranges::stable_sort(sorted, [](const Cluster &a, const Cluster &b) { return a.Sort > b.Sort; });
+
+        std::vector<uint32_t> result;
+        result.reserve(indices.size());
+        for (const Cluster &cluster: sorted)
+            result.insert(result.end(), indices.begin() + cluster.First * 3,
+                          indices.begin() + (cluster.First + cluster.Count) * 3);
+
+        std::ranges::copy(result, indices.begin());
+    }
+
+    void MeshOptimizer::OptimizeVertexFetch(std::vector<Vertex> &vertices, std::span<uint32_t> indices) {
+        std::vector<uint32_t> remap(vertices.size(), UINT32_MAX);
+        std::vector<Vertex> result;
+        result.reserve(vertices.size());
+
+        for (uint32_t &index: indices) {
+            if (remap[index] == UINT32_MAX) {
+                remap[index] = static_cast<uint32_t>(result.size());
+                result.push_back(vertices[index]);
+            }
+
+            index = remap[index];
+        }
+
+        // Vertices no triangle references are dropped
+        vertices = std::move(result);
+    }
+
+    MeshOptimizerStats MeshOptimizer::Optimize(MeshData &mesh) {
+        MeshOptimizerStats stats{};
+        stats.Before = AnalyzeVertexCache(mesh.Indices, mesh.Vertices.size());
+
+        std::vector<uint32_t> clusters;
+        OptimizeVertexCache(mesh.Indices, mesh.Vertices.size(), DEFAULT_CACHE_SIZE, &clusters);
+        OptimizeOverdraw(mesh.Indices, mesh.Vertices, clusters);
+        OptimizeVertexFetch(mesh.Vertices, mesh.Indices);
+
+        stats.After = AnalyzeVertexCache(mesh.Indices, mesh.Vertices.size());
+        return stats;
+    }
+} // Haus
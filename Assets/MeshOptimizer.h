@@ -0,0 +1,46 @@
+#ifndef HAUS_MESHOPTIMIZER_H
+#define HAUS_MESHOPTIMIZER_H
+
+#include "Mesh.h"
+
+namespace Haus {
+
+    // Average cache miss ratio per triangle and average transforms per vertex, for a FIFO post-transform cache
+    struct VertexCacheStats {
+        float ACMR;
+        float ATVR;
+    };
+
+    struct MeshOptimizerStats {
+        VertexCacheStats Before;
+        VertexCacheStats After;
+    };
+
+    class MeshOptimizer {
+    public:
+        static constexpr uint32_t DEFAULT_CACHE_SIZE = 16;
+
+        static VertexCacheStats AnalyzeVertexCache(std::span<const uint32_t> indices, size_t vertexCount,
+                                                   uint32_t cacheSize = DEFAULT_CACHE_SIZE);
+
+        /* Reorders triangles for the post-transform cache (Tipsify, Sander et al. 2007).
+           When clusters is given it receives the first triangle of every cluster, split where the cache restarts,
+           which OptimizeOverdraw can reorder without hurting cache locality much. */
+        static void OptimizeVertexCache(std::span<uint32_t> indices, size_t vertexCount,
+                                        uint32_t cacheSize = DEFAULT_CACHE_SIZE,
+                                        std::vector<uint32_t> *clusters = nullptr);
+
+        // Sorts clusters so outward facing ones, the likely occluders, are drawn first
+        static void OptimizeOverdraw(std::span<uint32_t> indices, std::span<const Vertex> vertices,
+                                     std::span<const uint32_t> clusters);
+
+        // Renumbers vertices in first-use order so vertex fetch walks memory linearly
+        static void OptimizeVertexFetch(std::vector<Vertex> &vertices, std::span<uint32_t> indices);
+
+        // Runs all of the above and returns the cache statistics before and after
+        static MeshOptimizerStats Optimize(MeshData &mesh);
+    };
+
+} // Haus
+
+#endif //HAUS_MESHOPTIMIZER_H
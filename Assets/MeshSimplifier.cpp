@@ -0,0 +1,319 @@
+#include "MeshSimplifier.h"
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+namespace Haus {
+    namespace {
+        // Collapses are sorted per pass, only this fraction of them is tried before the adjacency is rebuilt
+        constexpr float PASS_FRACTION = 0.25f;
+        // Collapses that turn a triangle normal further than this (cosine) are rejected as flips
+        constexpr float MIN_NORMAL_DOT = 0.2f;
+        // Levels deviating more than this fraction of the bounds diagonal no longer resemble the mesh
+        constexpr float MAX_RELATIVE_ERROR = 0.1f;
+
+        // Symmetric 4x4 matrix of the plane equation products, evaluated as v^T Q v
+        struct Quadric {
+            double A00, A01, A02, A03;
+            double A11, A12, A13;
+            double A22, A23;
+            double A33;
+
+            static Quadric FromPlane(const glm::dvec3 &normal, double distance) {
+                double a = normal.x, b = normal.y, c = normal.z, d = distance;
+                return {a * a, a * b, a * c, a * d, b * b, b * c, b * d, c * c, c * d, d * d};
+            }
+
+            Quadric &operator+=(const Quadric &other) {
+                A00 += other.A00, A01 += other.A01, A02 += other.A02, A03 += other.A03;
+                A11 += other.A11, A12 += other.A12, A13 += other.A13;
+                A22 += other.A22, A23 += other.A23;
+                A33 += other.A33;
+                return *this;
+            }
+
+            double Evaluate(const glm::vec3 &point) const {
+                double x = point.x, y = point.y, z = point.z;
+                double result = A00 * x * x + 2.0 * A01 * x * y + 2.0 * A02 * x * z + 2.0 * A03 * x +
+                                A11 * y * y + 2.0 * A12 * y * z + 2.0 * A13 * y +
+                                A22 * z * z + 2.0 * A23 * z +
+                                A33;
+                return std::max(result, 0.0);
+            }
+        };
+
+        struct Collapse {
+            uint32_t From;
+            uint32_t To;
+            double Error;
+        };
+
+        struct PositionHash {
+            size_t operator()(const glm::vec3 &position) const {
+                const auto *bits = reinterpret_cast<const uint32_t *>(&position);
+                return (static_cast<size_t>(bits[0]) * 73856093u) ^ (static_cast<size_t>(bits[1]) * 19349663u) ^
+                       (static_cast<size_t>(bits[2]) * 83492791u);
+            }
+        };
+
+        uint64_t EdgeKey(uint32_t a, uint32_t b) {
+            return (static_cast<uint64_t>(a) << 32) | b;
+        }
+
+        /* Vertices that must not move: seam vertices share their position with another vertex, border vertices
+           sit on an edge used by a single triangle. Edges are compared by position so seams do not look open. */
+        std::vector<bool> FindLockedVertices(std::span<const Vertex> vertices, std::span<const uint32_t> indices) {
+            std::vector<uint32_t> positionIds(vertices.size());
+            std::vector<uint32_t> wedgeCounts;
+            std::unordered_map<glm::vec3, uint32_t, PositionHash> positions;
+            positions.reserve(vertices.size());
+
+            for (size_t i = 0; i < vertices.size(); i++) {
+                auto [it, inserted] = positions.try_emplace(vertices[i].Position, static_cast<uint32_t>(wedgeCounts.size()));
+                if (inserted)
+                    wedgeCounts.push_back(0);
+
+                positionIds[i] = it->second;
+                wedgeCounts[it->second]++;
+            }
+
+            std::unordered_map<uint64_t, uint32_t> edges;
+            edges.reserve(indices.size());
+            for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+                for (size_t k = 0; k < 3; k++) {
+                    uint32_t a = positionIds[indices[t + k]];
+                    uint32_t b = positionIds[indices[t + (k + 1) % 3]];
+                    edges[EdgeKey(a, b)]++;
+                }
+            }
+
+            std::vector<bool> lockedPositions(wedgeCounts.size(), false);
+            for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+                for (size_t k = 0; k < 3; k++) {
+                    uint32_t a = positionIds[indices[t + k]];
+                    uint32_t b = positionIds[indices[t + (k + 1) % 3]];
+                    if (!edges.contains(EdgeKey(b, a)) || edges[EdgeKey(a, b)] > 1)
+                        lockedPositions[a] = lockedPositions[b] = true;
+                }
+            }
+
+            std::vector<bool> locked(vertices.size());
+            for (size_t i = 0; i < vertices.size(); i++)
+                locked[i] = wedgeCounts[positionIds[i]] > 1 || lockedPositions[positionIds[i]];
+
+            return locked;
+        }
+
+        // Triangles around every vertex, as offsets into the index buffer
+        void BuildAdjacency(std::span<const uint32_t> indices, size_t vertexCount,
+                            std::vector<uint32_t> &offsets, std::vector<uint32_t> &triangles) {
+            offsets.assign(vertexCount + 1, 0);
+            for (uint32_t index: indices)
+                offsets[index + 1]++;
+
+            for (size_t i = 0; i < vertexCount; i++)
+                offsets[i + 1] += offsets[i];
+
+            triangles.resize(indices.size());
+            std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+            for (size_t i = 0; i < indices.size(); i++)
+                triangles[cursor[indices[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+
+        // Rejects collapses that flip or degenerate one of the triangles that stay around from
+        bool FlipsTriangle(std::span<const Vertex> vertices, std::span<const uint32_t> indices,
+                           std::span<const uint32_t> triangles, uint32_t from, uint32_t to) {
+            for (uint32_t triangle: triangles) {
+                const uint32_t *corners = &indices[3 * triangle];
+                if (corners[0] == to || corners[1] == to || corners[2] == to)
+                    continue;
+
+                glm::vec3 before[3], after[3];
+                for (size_t k = 0; k < 3; k++) {
+                    before[k] = vertices[corners[k]].Position;
+                    after[k] = corners[k] == from ? vertices[to].Position : before[k];
+                }
+
+                glm::vec3 oldNormal = glm::cross(before[1] - before[0], before[2] - before[0]);
+                glm::vec3 newNormal = glm::cross(after[1] - after[0], after[2] - after[0]);
+                float oldLength = glm::length(oldNormal);
+                float newLength = glm::length(newNormal);
+                if (newLength == 0.0f)
+                    return true;
+
+                if (oldLength > 0.0f && glm::dot(oldNormal, newNormal) < MIN_NORMAL_DOT * oldLength * newLength)
+                    return true;
+            }
+
+            return false;
+        }
+    }
+
+    std::vector<uint32_t> MeshSimplifier::Simplify(std::span<const Vertex> vertices, std::span<const uint32_t> indices,
+                                                   size_t targetIndexCount, float &error) {
+        std::vector<uint32_t> result(indices.begin(), indices.end());
+        error = 0.0f;
+
+        std::vector<bool> locked = FindLockedVertices(vertices, indices);
+
+        std::vector<Quadric> quadrics(vertices.size(), Quadric{});
+        for (size_t t = 0; t + 2 < result.size(); t += 3) {
+            const glm::vec3 &a = vertices[result[t + 0]].Position;
+            const glm::vec3 &b = vertices[result[t + 1]].Position;
+            const glm::vec3 &c = vertices[result[t + 2]].Position;
+
+            glm::dvec3 normal = glm::cross(glm::dvec3(b - a), glm::dvec3(c - a));
+            double length = glm::length(normal);
+            if (length == 0.0)
+                continue;
+
+            normal /= length;
+            Quadric quadric = Quadric::FromPlane(normal, -glm::dot(normal, glm::dvec3(a)));
+            for (size_t k = 0; k < 3; k++)
+                quadrics[result[t + k]] += quadric;
+        }
+
+        std::vector<uint32_t> remap(vertices.size());
+        std::vector<bool> touched(vertices.size());
+        std::vector<uint32_t> offsets;
+        std::vector<uint32_t> triangles;
+        std::vector<Collapse> collapses;
+        double maxError = 0.0;
+
+        while (result.size() > targetIndexCount) {
+            BuildAdjacency(result, vertices.size(), offsets, triangles);
+
+            // Cheapest valid collapse of every unlocked vertex onto one of its neighbours, the error is measured at
+            // the neighbour since the vertex moves there
+            collapses.clear();
+            for (uint32_t vertex = 0; vertex < vertices.size(); vertex++) {
+                if (locked[vertex] || offsets[vertex] == offsets[vertex + 1])
+                    continue;
+
+                std::span<const uint32_t> around(&triangles[offsets[vertex]], &triangles[offsets[vertex + 1]]);
+                Collapse best{vertex, vertex, std::numeric_limits<double>::max()};
+                for (uint32_t triangle: around) {
+                    const uint32_t *corners = &result[3 * triangle];
+                    for (size_t k = 0; k < 3; k++) {
+                        uint32_t other = corners[k];
+                        if (other == vertex)
+                            continue;
+
+                        Quadric quadric = quadrics[vertex];
+                        quadric += quadrics[other];
+                        double cost = quadric.Evaluate(vertices[other].Position);
+                        if (cost < best.Error && !FlipsTriangle(vertices, result, around, vertex, other))
+                            best = {vertex, other, cost};
+                    }
+                }
+
+                if (best.To != vertex)
+                    collapses.push_back(best);
+            }
+
+            if (collapses.empty())
+                break;
+
+            std::sort(collapses.begin(), collapses.end(), [](const Collapse &a, const Collapse &b) {
+                return a.Error < b.Error;
+            });
+
+            for (uint32_t i = 0; i < remap.size(); i++)
+                remap[i] = i;
+            std::fill(touched.begin(), touched.end(), false);
+
+            size_t triangleCount = result.size() / 3;
+            size_t targetTriangleCount = targetIndexCount / 3;
+            size_t passLimit = std::max<size_t>(1, static_cast<size_t>(static_cast<float>(collapses.size()) * PASS_FRACTION));
+            size_t performed = 0;
+
+            for (const Collapse &collapse: collapses) {
+                if (triangleCount <= targetTriangleCount || performed >= passLimit)
+                    break;
+
+                // Neighbourhoods changed this pass have stale adjacency, they wait for the next one
+                if (touched[collapse.From] || touched[collapse.To])
+                    continue;
+
+                std::span<const uint32_t> around(&triangles[offsets[collapse.From]], &triangles[offsets[collapse.From + 1]]);
+                if (FlipsTriangle(vertices, result, around, collapse.From, collapse.To))
+                    continue;
+
+                remap[collapse.From] = collapse.To;
+                quadrics[collapse.To] += quadrics[collapse.From];
+                maxError = std::max(maxError, collapse.Error);
+
+                for (uint32_t triangle: around) {
+                    const uint32_t *corners = &result[3 * triangle];
+                    bool degenerate = false;
+                    for (size_t k = 0; k < 3; k++) {
+                        touched[corners[k]] = true;
+                        degenerate |= corners[k] == collapse.To;
+                    }
+
+                    triangleCount -= degenerate ? 1 : 0;
+                }
+
+                performed++;
+            }
+
+            if (performed == 0)
+                break;
+
+            size_t write = 0;
+            for (size_t t = 0; t + 2 < result.size(); t += 3) {
+                uint32_t a = remap[result[t + 0]];
+                uint32_t b = remap[result[t + 1]];
+                uint32_t c = remap[result[t + 2]];
+                if (a == b || b == c || c == a)
+                    continue;
+
+                result[write++] = a;
+                result[write++] = b;
+                result[write++] = c;
+            }
+
+            result.resize(write);
+        }
+
+        error = static_cast<float>(std::sqrt(maxError));
+        return result;
+    }
+
+    void MeshSimplifier::BuildLods(MeshData &mesh, uint32_t lodCount, float reduction) {
+        mesh.Lods.clear();
+        mesh.Lods.push_back({0, static_cast<uint32_t>(mesh.Indices.size()), 0, 0, 0, 0, 0.0f});
+
+        std::vector<uint32_t> previous = mesh.Indices;
+        size_t triangleCount = mesh.Indices.size() / 3;
+        float maxError = glm::length(mesh.Bounds.Max - mesh.Bounds.Min) * MAX_RELATIVE_ERROR;
+        float target = 1.0f;
+        float error = 0.0f;
+
+        for (uint32_t level = 1; level < lodCount; level++) {
+            target *= reduction;
+            auto targetIndexCount = static_cast<size_t>(static_cast<float>(triangleCount) * target) * 3;
+
+            float levelError = 0.0f;
+            std::vector<uint32_t> indices = Simplify(mesh.Vertices, previous, targetIndexCount, levelError);
+
+            // Locked seams and borders bound how far a mesh can go, a level that barely shrinks is not worth drawing
+            if (indices.empty() || indices.size() > previous.size() * 9 / 10)
+                break;
+
+            // Errors are measured against the previous level, their sum bounds the deviation from the original
+            error += levelError;
+            if (error > maxError)
+                break;
+
+            MeshOptimizer::OptimizeVertexCache(indices, mesh.Vertices.size());
+
+            mesh.Lods.push_back({static_cast<uint32_t>(mesh.Indices.size()), static_cast<uint32_t>(indices.size()),
+                                 0, 0, 0, 0, error});
+            mesh.Indices.insert(mesh.Indices.end(), indices.begin(), indices.end());
+            previous = std::move(indices);
+        }
+    }
+} // Haus
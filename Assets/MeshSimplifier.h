@@ -0,0 +1,24 @@
+#ifndef HAUS_MESHSIMPLIFIER_H
+#define HAUS_MESHSIMPLIFIER_H
+
+#include "Mesh.h"
+
+namespace Haus {
+
+    /* Quadric error metric simplification (Garland & Heckbert) by half-edge collapses onto existing vertices,
+       so every level can index the same vertex buffer. Vertices on UV or normal seams (several vertices sharing
+       a position) and on open borders are locked, which keeps seams and silhouettes of open meshes intact. */
+    class MeshSimplifier {
+    public:
+        // Returns the simplified indices, error receives the largest collapse error as an object space distance
+        static std::vector<uint32_t> Simplify(std::span<const Vertex> vertices, std::span<const uint32_t> indices,
+                                              size_t targetIndexCount, float &error);
+
+        /* Appends levels of detail with reduction, reduction^2, ... of the triangle count to mesh.Indices and
+           fills mesh.Lods, level zero is the existing index buffer. Stops early once a level no longer shrinks. */
+        static void BuildLods(MeshData &mesh, uint32_t lodCount, float reduction);
+    };
+
+} // Haus
+
+#endif //HAUS_MESHSIMPLIFIER_H
@@ -0,0 +1,147 @@
+#include "MeshletBuilder.h"
+
+#include <cmath>
+
+namespace Haus {
+    namespace {
+        // Cones wider than this (dot product of the narrowest normal with the axis) cull too rarely to be worth testing
+        constexpr float MIN_CONE_DOT = 0.1f;
+
+        // Ritter's bounding sphere
+        void ComputeSphere(std::span<const glm::vec3> points, glm::vec3 &center, float &radius) {
+            auto farthest = [&](const glm::vec3 &from) {
+                glm::vec3 result = points[0];
+                float best = -1.0f;
+                for (const glm::vec3 &point: points) {
+                    float distance = glm::dot(point - from, point - from);
+                    if (distance > best) {
+                        best = distance;
+                        result = point;
+                    }
+                }
+                return result;
+            };
+
+            glm::vec3 a = farthest(points[0]);
+            glm::vec3 b = farthest(a);
+
+            center = (a + b) * 0.5f;
+            radius = glm::length(b - a) * 0.5f;
+
+            for (const glm::vec3 &point: points) {
+                float distance = glm::length(point - center);
+                if (distance > radius) {
+                    float grown = (radius + distance) * 0.5f;
+                    center += (point - center) * ((grown - radius) / distance);
+                    radius = grown;
+                }
+            }
+        }
+
+        void ComputeBounds(const MeshData &mesh, Meshlet &meshlet, std::span<const glm::vec3> points) {
+            ComputeSphere(points, meshlet.Center, meshlet.Radius);
+
+            std::vector<glm::vec3> normals;
+            std::vector<glm::vec3> corners;
+            glm::vec3 axis{0.0f};
+
+            for (uint32_t i = meshlet.FirstIndex; i < meshlet.FirstIndex + meshlet.IndexCount; i += 3) {
+                const glm::vec3 &a = mesh.Vertices[meshlet.VertexOffset + mesh.Indices[i + 0]].Position;
+                const glm::vec3 &b = mesh.Vertices[meshlet.VertexOffset + mesh.Indices[i + 1]].Position;
+                const glm::vec3 &c = mesh.Vertices[meshlet.VertexOffset + mesh.Indices[i + 2]].Position;
+
+                glm::vec3 normal = glm::cross(b - a, c - a);
+                float length = glm::length(normal);
+                if (length == 0.0f)
+                    continue;
+
+                normal /= length;
+                normals.push_back(normal);
+                corners.push_back(a);
+                axis += normal;
+            }
+
+            meshlet.ConeApex = meshlet.Center;
+            meshlet.ConeAxis = glm::vec3(0.0f, 0.0f, 1.0f);
+            meshlet.ConeCutoff = 1.0f;
+
+            float axisLength = glm::length(axis);
+            if (axisLength == 0.0f)
+                return;
+
+            axis /= axisLength;
+
+            float minDot = 1.0f;
+            for (const glm::vec3 &normal: normals)
+                minDot = std::min(minDot, glm::dot(normal, axis));
+
+            if (minDot <= MIN_CONE_DOT)
+                return;
+
+            // Move the apex back along the axis until every triangle plane is in front of it
+            float maxDistance = 0.0f;
+            for (size_t i = 0; i < normals.size(); i++) {
+                float distance = glm::dot(meshlet.Center - corners[i], normals[i]) / glm::dot(axis, normals[i]);
+                maxDistance = std::max(maxDistance, distance);
+            }
+
+            meshlet.ConeApex = meshlet.Center - axis * maxDistance;
+            meshlet.ConeAxis = axis;
+            meshlet.ConeCutoff = std::sqrt(1.0f - minDot * minDot);
+        }
+    }
+
+    void MeshletBuilder::Build(MeshData &mesh) {
+        mesh.Meshlets.clear();
+
+        std::vector<uint32_t> stamps(mesh.Vertices.size(), UINT32_MAX);
+        std::vector<glm::vec3> points;
+        points.reserve(MAX_VERTICES);
+
+        auto meshletIndex = static_cast<uint32_t>(0);
+
+        for (MeshLod &lod: mesh.Lods) {
+            lod.FirstMeshlet = static_cast<uint32_t>(mesh.Meshlets.size());
+
+            for (const MeshBatch &batch: std::span(mesh.Batches).subspan(lod.FirstBatch, lod.BatchCount)) {
+                Meshlet meshlet{.FirstIndex = batch.FirstIndex, .IndexCount = 0, .VertexOffset = batch.VertexOffset};
+
+                auto finish = [&]() {
+                    if (meshlet.IndexCount == 0)
+                        return;
+
+                    ComputeBounds(mesh, meshlet, points);
+                    mesh.Meshlets.push_back(meshlet);
+
+                    meshlet = {.FirstIndex = meshlet.FirstIndex + meshlet.IndexCount, .IndexCount = 0,
+                               .VertexOffset = batch.VertexOffset};
+                    points.clear();
+                    meshletIndex++;
+                };
+
+                for (uint32_t i = batch.FirstIndex; i < batch.FirstIndex + batch.IndexCount; i += 3) {
+                    uint32_t newVertices = 0;
+                    for (uint32_t k = 0; k < 3; k++)
+                        newVertices += stamps[batch.VertexOffset + mesh.Indices[i + k]] == meshletIndex ? 0 : 1;
+
+                    if (points.size() + newVertices > MAX_VERTICES || meshlet.IndexCount / 3 >= MAX_TRIANGLES)
+                        finish();
+
+                    for (uint32_t k = 0; k < 3; k++) {
+                        uint32_t vertex = batch.VertexOffset + mesh.Indices[i + k];
+                        if (stamps[vertex] != meshletIndex) {
+                            stamps[vertex] = meshletIndex;
+                            points.push_back(mesh.Vertices[vertex].Position);
+                        }
+                    }
+
+                    meshlet.IndexCount += 3;
+                }
+
+                finish();
+            }
+
+            lod.MeshletCount = static_cast<uint32_t>(mesh.Meshlets.size()) - lod.FirstMeshlet;
+        }
+    }
+} // Haus
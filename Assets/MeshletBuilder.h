@@ -0,0 +1,21 @@
+#ifndef HAUS_MESHLETBUILDER_H
+#define HAUS_MESHLETBUILDER_H
+
+#include "Mesh.h"
+
+namespace Haus {
+
+    /* Splits every batch into meshlets of contiguous triangles and computes their culling bounds.
+       Triangles are consumed in index order, so the vertex cache order of the optimizer is kept and every
+       meshlet is a plain index range that can be drawn or skipped without touching the index buffer. */
+    class MeshletBuilder {
+    public:
+        static constexpr uint32_t MAX_VERTICES = 64;
+        static constexpr uint32_t MAX_TRIANGLES = 124;
+
+        static void Build(MeshData &mesh);
+    };
+
+} // Haus
+
+#endif //HAUS_MESHLETBUILDER_H
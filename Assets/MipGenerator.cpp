@@ -0,0 +1,291 @@
+#include "MipGenerator.h"
+#include "TextureImporter.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numbers>
+#include <stdexcept>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace Haus {
+    namespace {
+        constexpr uint32_t CHANNELS = 4;
+        constexpr size_t ROW_GRAIN = 16;
+        constexpr float KAISER_ALPHA = 4.0f;
+        constexpr float KAISER_RADIUS = 3.0f;
+
+        /* Weights of one 2:1 reduction, destination texel i reads the source texels from 2i + First on. The
+           taps are symmetric around 2i + 0.5, the center of the texels the destination covers. */
+        struct Kernel {
+            int32_t First;
+            std::vector<float> Weights;
+        };
+
+        // Modified Bessel function of the first kind, order zero
+        float BesselI0(float x) {
+            float sum = 1.0f;
+            float term = 1.0f;
+            for (int k = 1; k < 16; k++) {
+                term *= (x / (2.0f * static_cast<float>(k))) * (x / (2.0f * static_cast<float>(k)));
+                sum += term;
+            }
+            return sum;
+        }
+
+        Kernel CreateKernel(MipFilter filter) {
+            if (filter == MipFilter::Box)
+                return {0, {0.5f, 0.5f}};
+
+            Kernel kernel{-2, {}};
+            float sum = 0.0f;
+            for (int32_t k = kernel.First; k <= 3; k++) {
+                // Distance in source texels, the cutoff of the halved resolution makes the sinc twice as wide
+                float distance = static_cast<float>(k) - 0.5f;
+                float x = distance * 0.5f * std::numbers::pi_v<float>;
+                float sinc = std::sin(x) / x;
+
+                float t = distance / KAISER_RADIUS;
+                float window = BesselI0(KAISER_ALPHA * std::sqrt(1.0f - t * t)) / BesselI0(KAISER_ALPHA);
+
+                kernel.Weights.push_back(sinc * window);
+                sum += sinc * window;
+            }
+
+            for (float &weight: kernel.Weights)
+                weight /= sum;
+
+            return kernel;
+        }
+
+        const std::array<float, 256> &GetDecodeTable(bool srgb) {
+            static const auto table = [] {
+                std::array<std::array<float, 256>, 2> tables{};
+                for (uint32_t i = 0; i < 256; i++) {
+                    float value = static_cast<float>(i) / 255.0f;
+                    tables[0][i] = value;
+                    tables[1][i] = value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+                }
+                return tables;
+            }();
+
+            return table[srgb ? 1 : 0];
+        }
+
+        // Linear to sRGB, indexed by the linear value scaled to 16 bits, fine enough to round like the formula
+        const std::vector<uint8_t> &GetEncodeTable() {
+            static const std::vector<uint8_t> table = [] {
+                std::vector<uint8_t> values(65536);
+                for (uint32_t i = 0; i < values.size(); i++) {
+                    float value = static_cast<float>(i) / 65535.0f;
+                    float encoded = value <= 0.0031308f ? value * 12.92f
+                                                        : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+                    values[i] = static_cast<uint8_t>(std::lround(std::clamp(encoded, 0.0f, 1.0f) * 255.0f));
+                }
+                return values;
+            }();
+
+            return table;
+        }
+
+        void FilterRowScalar(const float *padded, float *destination, uint32_t width, const Kernel &kernel,
+                             uint32_t firstTexel) {
+            for (uint32_t x = firstTexel; x < width; x++) {
+                float sum[CHANNELS]{};
+                for (size_t k = 0; k < kernel.Weights.size(); k++) {
+                    const float *texel = padded + (2 * x + k) * CHANNELS;
+                    for (uint32_t c = 0; c < CHANNELS; c++)
+                        sum[c] += kernel.Weights[k] * texel[c];
+                }
+
+                for (uint32_t c = 0; c < CHANNELS; c++)
+                    destination[x * CHANNELS + c] = sum[c];
+            }
+        }
+
+        void FilterColumnScalar(const float *const *rows, float *destination, size_t count, const Kernel &kernel,
+                                size_t first) {
+            for (size_t i = first; i < count; i++) {
+                float sum = 0.0f;
+                for (size_t k = 0; k < kernel.Weights.size(); k++)
+                    sum += kernel.Weights[k] * rows[k][i];
+
+                destination[i] = sum;
+            }
+        }
+
+#if defined(__x86_64__)
+        // Two destination texels per register, their taps are two source texels apart
+        __attribute__((target("avx2,fma")))
+        void FilterRowAvx2(const float *padded, float *destination, uint32_t width, const Kernel &kernel) {
+            uint32_t x = 0;
+            for (; x + 2 <= width; x += 2) {
+                __m256 sum = _mm256_setzero_ps();
+                for (size_t k = 0; k < kernel.Weights.size(); k++) {
+                    const float *texel = padded + (2 * x + k) * CHANNELS;
+                    __m256 texels = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(texel)),
+                                                         _mm_loadu_ps(texel + 2 * CHANNELS), 1);
+                    sum = _mm256_fmadd_ps(_mm256_set1_ps(kernel.Weights[k]), texels, sum);
+                }
+                _mm256_storeu_ps(destination + x * CHANNELS, sum);
+            }
+
+            FilterRowScalar(padded, destination, width, kernel, x);
+        }
+
+        __attribute__((target("avx2,fma")))
+        void FilterColumnAvx2(const float *const *rows, float *destination, size_t count, const Kernel &kernel) {
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8) {
+                __m256 sum = _mm256_setzero_ps();
+                for (size_t k = 0; k < kernel.Weights.size(); k++)
+                    sum = _mm256_fmadd_ps(_mm256_set1_ps(kernel.Weights[k]), _mm256_loadu_ps(rows[k] + i), sum);
+
+                _mm256_storeu_ps(destination + i, sum);
+            }
+
+            FilterColumnScalar(rows, destination, count, kernel, i);
+        }
+#endif
+
+        bool HasAvx2() {
+#if defined(__x86_64__)
+            static const bool avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+            return avx2;
+#else
+            return false;
+#endif
+        }
+
+        // Reduces the width of the rows [firstRow, endRow), the edges are clamped through a padded copy of each row
+        void FilterRows(const std::vector<float> &source, uint32_t sourceWidth, std::vector<float> &destination,
+                        uint32_t width, const Kernel &kernel, size_t firstRow, size_t endRow) {
+            auto before = static_cast<uint32_t>(-kernel.First);
+            auto after = static_cast<uint32_t>(kernel.Weights.size());
+            std::vector<float> padded((before + sourceWidth + after) * CHANNELS);
+
+            for (size_t y = firstRow; y < endRow; y++) {
+                const float *row = source.data() + y * sourceWidth * CHANNELS;
+                for (uint32_t i = 0; i < before + sourceWidth + after; i++) {
+                    int64_t x = std::clamp<int64_t>(static_cast<int64_t>(i) - before, 0, sourceWidth - 1);
+                    std::copy_n(row + x * CHANNELS, CHANNELS, padded.data() + i * CHANNELS);
+                }
+
+                // The padding moves the first tap of every destination texel to 2x
+                float *output = destination.data() + y * width * CHANNELS;
+#if defined(__x86_64__)
+                if (HasAvx2()) {
+                    FilterRowAvx2(padded.data(), output, width, kernel);
+                    continue;
+                }
+#endif
+                FilterRowScalar(padded.data(), output, width, kernel, 0);
+            }
+        }
+
+        void FilterColumns(const std::vector<float> &source, uint32_t sourceHeight, std::vector<float> &destination,
+                           uint32_t width, const Kernel &kernel, size_t firstRow, size_t endRow) {
+            size_t rowSize = static_cast<size_t>(width) * CHANNELS;
+            std::vector<const float *> rows(kernel.Weights.size());
+
+            for (size_t y = firstRow; y < endRow; y++) {
+                for (size_t k = 0; k < rows.size(); k++) {
+                    int64_t sourceRow = std::clamp<int64_t>(2 * static_cast<int64_t>(y) + kernel.First +
+                                                            static_cast<int64_t>(k), 0, sourceHeight - 1);
+                    rows[k] = source.data() + sourceRow * rowSize;
+                }
+
+                float *output = destination.data() + y * rowSize;
+#if defined(__x86_64__)
+                if (HasAvx2()) {
+                    FilterColumnAvx2(rows.data(), output, rowSize, kernel);
+                    continue;
+                }
+#endif
+                FilterColumnScalar(rows.data(), output, rowSize, kernel, 0);
+            }
+        }
+
+        // Back to RGBA8, undoing the alpha weighting, the negative lobes of the Kaiser filter are clamped away
+        void Quantize(const float *source, std::byte *destination, size_t texels, bool srgb) {
+            const std::vector<uint8_t> &encode = GetEncodeTable();
+
+            for (size_t i = 0; i < texels; i++) {
+                const float *texel = source + i * CHANNELS;
+                float alpha = std::clamp(texel[3], 0.0f, 1.0f);
+
+                for (uint32_t c = 0; c < 3; c++) {
+                    float value = alpha > 0.0f ? std::clamp(texel[c] / alpha, 0.0f, 1.0f) : 0.0f;
+                    destination[i * CHANNELS + c] = static_cast<std::byte>(
+                            srgb ? encode[static_cast<size_t>(value * 65535.0f + 0.5f)]
+                                 : static_cast<uint8_t>(value * 255.0f + 0.5f));
+                }
+                destination[i * CHANNELS + 3] = static_cast<std::byte>(static_cast<uint8_t>(alpha * 255.0f + 0.5f));
+            }
+        }
+    }
+
+    bool MipGenerator::IsFormatSupported(vk::Format format) {
+        return format == vk::Format::eR8G8B8A8Unorm || format == vk::Format::eR8G8B8A8Srgb;
+    }
+
+    void MipGenerator::Generate(TextureData &texture, MipFilter filter, ThreadPool *pool) {
+        if (!IsFormatSupported(texture.Format) || texture.Layers != 1 || texture.Mips.empty() ||
+            texture.Mips[0].Offset != 0)
+            throw std::invalid_argument("MipGenerator: Expected RGBA8 texture data starting with the first level");
+
+        bool srgb = texture.Format == vk::Format::eR8G8B8A8Srgb;
+        Kernel kernel = CreateKernel(filter);
+
+        uint32_t mipCount = TextureImporter::GetMipCount(texture.Width, texture.Height);
+        texture.Mips.resize(1);
+        uint64_t size = texture.Mips[0].Size;
+        for (uint32_t level = 1; level < mipCount; level++) {
+            uint32_t mipWidth = std::max(texture.Width >> level, 1u);
+            uint32_t mipHeight = std::max(texture.Height >> level, 1u);
+            uint64_t mipSize = static_cast<uint64_t>(mipWidth) * mipHeight * CHANNELS;
+
+            texture.Mips.push_back({size, mipSize, mipWidth, mipHeight});
+            size += mipSize;
+        }
+        texture.Pixels.resize(size);
+
+        // Linear and weighted by alpha, every level after the first is filtered from the one before it
+        const std::array<float, 256> &decode = GetDecodeTable(srgb);
+        std::vector<float> current(static_cast<size_t>(texture.Width) * texture.Height * CHANNELS);
+        ParallelFor(pool, texture.Height, ROW_GRAIN * 4, [&](size_t begin, size_t end) {
+            for (size_t i = begin * texture.Width; i < end * texture.Width; i++) {
+                const auto *texel = reinterpret_cast<const uint8_t *>(texture.Pixels.data()) + i * CHANNELS;
+                float alpha = static_cast<float>(texel[3]) / 255.0f;
+                for (uint32_t c = 0; c < 3; c++)
+                    current[i * CHANNELS + c] = decode[texel[c]] * alpha;
+                current[i * CHANNELS + 3] = alpha;
+            }
+        });
+
+        std::vector<float> rows;
+        std::vector<float> next;
+        for (uint32_t level = 1; level < mipCount; level++) {
+            const TextureMip &source = texture.Mips[level - 1];
+            const TextureMip &mip = texture.Mips[level];
+
+            rows.resize(static_cast<size_t>(mip.Width) * source.Height * CHANNELS);
+            ParallelFor(pool, source.Height, ROW_GRAIN, [&](size_t begin, size_t end) {
+                FilterRows(current, source.Width, rows, mip.Width, kernel, begin, end);
+            });
+
+            next.resize(static_cast<size_t>(mip.Width) * mip.Height * CHANNELS);
+            ParallelFor(pool, mip.Height, ROW_GRAIN, [&](size_t begin, size_t end) {
+                FilterColumns(rows, source.Height, next, mip.Width, kernel, begin, end);
+                Quantize(next.data() + begin * mip.Width * CHANNELS,
+                         texture.Pixels.data() + mip.Offset + begin * mip.Width * CHANNELS,
+                         (end - begin) * mip.Width, srgb);
+            });
+
+            std::swap(current, next);
+        }
+    }
+} // Haus
@@ -0,0 +1,30 @@
+#ifndef HAUS_MIPGENERATOR_H
+#define HAUS_MIPGENERATOR_H
+
+#include "Texture.h"
+#include "ThreadPool.h"
+
+namespace Haus {
+
+    enum class MipFilter : uint32_t {
+        // 2x2 average, cheapest and softest
+        Box,
+        // Kaiser windowed sinc over six texels, keeps mips sharper without visible ringing
+        Kaiser
+    };
+
+    /* CPU mip chain builder for RGBA8 textures. Color of sRGB formats is filtered in linear space and every
+       texel is weighted by its alpha, so mips keep their brightness and transparent texels do not bleed into
+       opaque ones. Each level is filtered separably from the previous one in float, with AVX2 when the CPU
+       has it, and the rows of every pass are spread over the pool. */
+    class MipGenerator {
+    public:
+        static bool IsFormatSupported(vk::Format format);
+
+        // Replaces whatever follows the first level, which has to start at offset zero, with the full chain
+        static void Generate(TextureData &texture, MipFilter filter, ThreadPool *pool);
+    };
+
+} // Haus
+
+#endif //HAUS_MIPGENERATOR_H
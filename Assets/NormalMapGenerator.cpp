@@ -0,0 +1,163 @@
+#include "NormalMapGenerator.h"
+
+#include <cmath>
+#include <stdexcept>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace Haus {
+    namespace {
+        constexpr uint32_t CHANNELS = 4;
+        constexpr size_t ROW_GRAIN = 32;
+
+        uint32_t EncodeNormal(float x, float y, float z) {
+            float length = std::sqrt(x * x + y * y + z * z);
+            auto encode = [&](float value) {
+                return static_cast<uint32_t>(std::lround(value / length * 127.5f + 127.5f));
+            };
+
+            return encode(x) | encode(y) << 8 | encode(z) << 16 | 0xFF000000u;
+        }
+
+        // Texels [first, end) of a row, the neighbours wrap around the row
+        void SobelRowScalar(const uint8_t *above, const uint8_t *row, const uint8_t *below, uint32_t width,
+                            float scale, uint32_t *output, uint32_t first, uint32_t end) {
+            for (uint32_t x = first; x < end; x++) {
+                uint32_t left = x == 0 ? width - 1 : x - 1;
+                uint32_t right = x + 1 == width ? 0 : x + 1;
+
+                int32_t dx = (above[right] + 2 * row[right] + below[right]) - (above[left] + 2 * row[left] + below[left]);
+                int32_t dy = (below[left] + 2 * below[x] + below[right]) - (above[left] + 2 * above[x] + above[right]);
+
+                output[x] = EncodeNormal(-static_cast<float>(dx) * scale, -static_cast<float>(dy) * scale, 1.0f);
+            }
+        }
+
+#if defined(__x86_64__)
+        __attribute__((target("avx2,fma")))
+        __m256 LoadHeights(const uint8_t *heights) {
+            __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(heights));
+            return _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(bytes));
+        }
+
+        // Eight texels at a time away from the edges, which are left to the scalar path for the wrap around
+        __attribute__((target("avx2,fma")))
+        void SobelRowAvx2(const uint8_t *above, const uint8_t *row, const uint8_t *below, uint32_t width,
+                          float scale, uint32_t *output) {
+            const __m256 two = _mm256_set1_ps(2.0f);
+            const __m256 negativeScale = _mm256_set1_ps(-scale);
+            const __m256 half = _mm256_set1_ps(127.5f);
+
+            uint32_t x = 1;
+            for (; x + 8 < width; x += 8) {
+                __m256 aboveLeft = LoadHeights(above + x - 1);
+                __m256 aboveCenter = LoadHeights(above + x);
+                __m256 aboveRight = LoadHeights(above + x + 1);
+                __m256 rowLeft = LoadHeights(row + x - 1);
+                __m256 rowRight = LoadHeights(row + x + 1);
+                __m256 belowLeft = LoadHeights(below + x - 1);
+                __m256 belowCenter = LoadHeights(below + x);
+                __m256 belowRight = LoadHeights(below + x + 1);
+
+                __m256 dx = _mm256_sub_ps(_mm256_fmadd_ps(two, rowRight, _mm256_add_ps(aboveRight, belowRight)),
+                                          _mm256_fmadd_ps(two, rowLeft, _mm256_add_ps(aboveLeft, belowLeft)));
+                __m256 dy = _mm256_sub_ps(_mm256_fmadd_ps(two, belowCenter, _mm256_add_ps(belowLeft, belowRight)),
+                                          _mm256_fmadd_ps(two, aboveCenter, _mm256_add_ps(aboveLeft, aboveRight)));
+
+                __m256 nx = _mm256_mul_ps(dx, negativeScale);
+                __m256 ny = _mm256_mul_ps(dy, negativeScale);
+                __m256 lengthSquared = _mm256_fmadd_ps(nx, nx, _mm256_fmadd_ps(ny, ny, _mm256_set1_ps(1.0f)));
+                __m256 encodeScale = _mm256_div_ps(half, _mm256_sqrt_ps(lengthSquared));
+
+                __m256i red = _mm256_cvtps_epi32(_mm256_fmadd_ps(nx, encodeScale, half));
+                __m256i green = _mm256_cvtps_epi32(_mm256_fmadd_ps(ny, encodeScale, half));
+                __m256i blue = _mm256_cvtps_epi32(_mm256_add_ps(encodeScale, half));
+
+                __m256i texels = _mm256_or_si256(_mm256_or_si256(red, _mm256_slli_epi32(green, 8)),
+                                                 _mm256_or_si256(_mm256_slli_epi32(blue, 16),
+                                                                 _mm256_set1_epi32(static_cast<int>(0xFF000000u))));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(output + x), texels);
+            }
+
+            SobelRowScalar(above, row, below, width, scale, output, 0, 1);
+            SobelRowScalar(above, row, below, width, scale, output, x, width);
+        }
+#endif
+
+        void SobelRow(const uint8_t *above, const uint8_t *row, const uint8_t *below, uint32_t width, float scale,
+                      uint32_t *output) {
+#if defined(__x86_64__)
+            static const bool avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+            if (avx2) {
+                SobelRowAvx2(above, row, below, width, scale, output);
+                return;
+            }
+#endif
+            SobelRowScalar(above, row, below, width, scale, output, 0, width);
+        }
+    }
+
+    TextureData NormalMapGenerator::FromHeight(std::span<const uint8_t> heights, uint32_t width, uint32_t height,
+                                               float heightScale, ThreadPool *pool) {
+        if (width == 0 || height == 0 || heights.size() != static_cast<size_t>(width) * height)
+            throw std::invalid_argument("NormalMapGenerator: Heights do not match the size");
+
+        uint64_t size = static_cast<uint64_t>(width) * height * CHANNELS;
+        TextureData texture{
+                .Format = vk::Format::eR8G8B8A8Unorm,
+                .Width = width,
+                .Height = height,
+                .Mips = {{0, size, width, height}}
+        };
+        texture.Pixels.resize(size);
+
+        // Both Sobel kernels weigh four texels on each side, two texels apart, so the slope is the sum over eight
+        float scale = heightScale / (8.0f * 255.0f);
+        auto *output = reinterpret_cast<uint32_t *>(texture.Pixels.data());
+
+        ParallelFor(pool, height, ROW_GRAIN, [&](size_t begin, size_t end) {
+            for (size_t y = begin; y < end; y++) {
+                const uint8_t *row = heights.data() + y * width;
+                const uint8_t *above = heights.data() + (y == 0 ? height - 1 : y - 1) * width;
+                const uint8_t *below = heights.data() + (y + 1 == height ? 0 : y + 1) * width;
+
+                SobelRow(above, row, below, width, scale, output + y * width);
+            }
+        });
+
+        return texture;
+    }
+
+    TextureData NormalMapGenerator::KeepRedGreen(const TextureView &texture) {
+        if (texture.Format != vk::Format::eR8G8B8A8Unorm)
+            throw std::invalid_argument("NormalMapGenerator: Expected an RGBA8 unorm texture");
+
+        TextureData result{
+                .Format = vk::Format::eR8G8Unorm,
+                .Width = texture.Width,
+                .Height = texture.Height
+        };
+
+        uint64_t size = 0;
+        for (const TextureMip &mip: texture.Mips) {
+            uint64_t texels = static_cast<uint64_t>(mip.Width) * mip.Height;
+            result.Mips.push_back({size, texels * 2, mip.Width, mip.Height});
+            size += texels * 2;
+        }
+        result.Pixels.resize(size);
+
+        for (size_t level = 0; level < texture.Mips.size(); level++) {
+            const std::byte *source = texture.Data.data() + texture.Mips[level].Offset;
+            std::byte *destination = result.Pixels.data() + result.Mips[level].Offset;
+
+            for (uint64_t i = 0; i < result.Mips[level].Size / 2; i++) {
+                destination[2 * i + 0] = source[CHANNELS * i + 0];
+                destination[2 * i + 1] = source[CHANNELS * i + 1];
+            }
+        }
+
+        return result;
+    }
+} // Haus
@@ -0,0 +1,25 @@
+#ifndef HAUS_NORMALMAPGENERATOR_H
+#define HAUS_NORMALMAPGENERATOR_H
+
+#include "Texture.h"
+#include "ThreadPool.h"
+
+namespace Haus {
+
+    /* Derives tangent space normal maps from height maps with a 3x3 Sobel filter, x along increasing texture
+       columns and y along increasing rows. The filter wraps around the edges like the repeat sampler does, it
+       is vectorized with AVX2 when the CPU has it and rows are spread over the pool. */
+    class NormalMapGenerator {
+    public:
+        /* Normals of one byte per texel heights as RGBA8 unorm, with alpha opaque. heightScale is the height of
+           the full byte range measured in texels, larger values give steeper normals. */
+        static TextureData FromHeight(std::span<const uint8_t> heights, uint32_t width, uint32_t height,
+                                      float heightScale, ThreadPool *pool);
+
+        // Red and green of every level of an RGBA8 texture as RG8, the shader rebuilds z from them
+        static TextureData KeepRedGreen(const TextureView &texture);
+    };
+
+} // Haus
+
+#endif //HAUS_NORMALMAPGENERATOR_H
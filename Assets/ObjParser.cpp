@@ -0,0 +1,350 @@
+#include "ObjParser.h"
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace Haus {
+    namespace {
+        // Below this a chunk is not worth a thread
+        constexpr size_t MIN_CHUNK_SIZE = 1 << 20;
+
+        constexpr uint8_t RELATIVE_POSITION = 1 << 0;
+        constexpr uint8_t RELATIVE_TEXTURE_COORD = 1 << 1;
+        constexpr uint8_t RELATIVE_NORMAL = 1 << 2;
+
+        /* Negative OBJ indices are relative to the attributes seen so far. A chunk only knows its local
+           counts, so those corners are stored chunk-relative and rebased once all chunk sizes are known. */
+        struct ObjChunk {
+            ObjData Data;
+            std::vector<uint8_t> RelativeMasks; // One per polygon corner
+            std::vector<uint32_t> FaceSizes;
+            size_t TriangleCount = 0;
+            std::string Error;
+        };
+
+        bool IsSpace(char c) {
+            return c == ' ' || c == '\t' || c == '\r';
+        }
+
+        const char *SkipSpaces(const char *p, const char *end) {
+            while (p < end && IsSpace(*p))
+                p++;
+            return p;
+        }
+
+        const char *ParseFloat(const char *p, const char *end, float &value) {
+            p = SkipSpaces(p, end);
+            if (p < end && *p == '+')
+                p++;
+
+            auto [next, error] = std::from_chars(p, end, value);
+            return error == std::errc() ? next : nullptr;
+        }
+
+        // Parses "v", "v/vt", "v//vn" or "v/vt/vn", returning nullptr on malformed input
+        const char *ParseCorner(const char *p, const char *end, int32_t (&values)[3]) {
+            values[0] = values[1] = values[2] = 0;
+
+            for (int component = 0; component < 3; component++) {
+                if (component > 0) {
+                    if (p >= end || *p != '/')
+                        break;
+                    p++;
+
+                    // Empty texture coordinate as in "v//vn"
+                    if (p < end && *p == '/')
+                        continue;
+                }
+
+                auto [next, error] = std::from_chars(p, end, values[component]);
+                if (error != std::errc() || values[component] == 0)
+                    return nullptr;
+                p = next;
+            }
+
+            return p;
+        }
+
+        int32_t ResolveIndex(int32_t value, size_t localCount, uint8_t relativeBit, uint8_t &mask) {
+            if (value > 0)
+                return value - 1;
+            if (value == 0)
+                return -1;
+
+            mask |= relativeBit;
+            return static_cast<int32_t>(static_cast<int64_t>(localCount) + value);
+        }
+
+        void ParseChunk(const char *begin, const char *end, ObjChunk &chunk) {
+            ObjData &data = chunk.Data;
+            const char *line = begin;
+
+            while (line < end) {
+                const char *lineEnd = static_cast<const char *>(memchr(line, '\n', end - line));
+                if (!lineEnd)
+                    lineEnd = end;
+
+                const char *p = SkipSpaces(line, lineEnd);
+
+                if (lineEnd - p >= 2 && p[0] == 'v' && IsSpace(p[1])) {
+                    float x, y, z;
+                    if (!(p = ParseFloat(p + 1, lineEnd, x)) || !(p = ParseFloat(p, lineEnd, y)) ||
+                        !(p = ParseFloat(p, lineEnd, z))) {
+                        chunk.Error = "Malformed vertex position";
+                        return;
+                    }
+                    data.Positions.insert(data.Positions.end(), {x, y, z});
+                } else if (lineEnd - p >= 3 && p[0] == 'v' && p[1] == 't' && IsSpace(p[2])) {
+                    float u, v = 0.0f;
+                    if (!(p = ParseFloat(p + 2, lineEnd, u))) {
+                        chunk.Error = "Malformed texture coordinate";
+                        return;
+                    }
+                    ParseFloat(p, lineEnd, v);
+                    data.TextureCoords.insert(data.TextureCoords.end(), {u, v});
+                } else if (lineEnd - p >= 3 && p[0] == 'v' && p[1] == 'n' && IsSpace(p[2])) {
+                    float x, y, z;
+                    if (!(p = ParseFloat(p + 2, lineEnd, x)) || !(p = ParseFloat(p, lineEnd, y)) ||
+                        !(p = ParseFloat(p, lineEnd, z))) {
+                        chunk.Error = "Malformed vertex normal";
+                        return;
+                    }
+                    data.Normals.insert(data.Normals.end(), {x, y, z});
+                } else if (lineEnd - p >= 2 && p[0] == 'f' && IsSpace(p[1])) {
+                    uint32_t faceSize = 0;
+                    p = SkipSpaces(p + 1, lineEnd);
+
+                    while (p < lineEnd) {
+                        int32_t values[3];
+                        p = ParseCorner(p, lineEnd, values);
+                        if (!p) {
+                            chunk.Error = "Malformed face";
+                            return;
+                        }
+
+                        uint8_t mask = 0;
+                        data.Corners.push_back({
+                                ResolveIndex(values[0], data.Positions.size() / 3, RELATIVE_POSITION, mask),
+                                ResolveIndex(values[1], data.TextureCoords.size() / 2, RELATIVE_TEXTURE_COORD, mask),
+                                ResolveIndex(values[2], data.Normals.size() / 3, RELATIVE_NORMAL, mask),
+                        });
+                        chunk.RelativeMasks.push_back(mask);
+                        faceSize++;
+
+                        p = SkipSpaces(p, lineEnd);
+                    }
+
+                    if (faceSize < 3) {
+                        chunk.Error = "Face with less than three vertices";
+                        return;
+                    }
+
+                    chunk.FaceSizes.push_back(faceSize);
+                    chunk.TriangleCount += faceSize - 2;
+                }
+
+                line = lineEnd + 1;
+            }
+        }
+
+        float SquaredDistance(const std::vector<float> &positions, int32_t a, int32_t b) {
+            float dx = positions[3 * b + 0] - positions[3 * a + 0];
+            float dy = positions[3 * b + 1] - positions[3 * a + 1];
+            float dz = positions[3 * b + 2] - positions[3 * a + 2];
+            return dx * dx + dy * dy + dz * dz;
+        }
+
+        bool IsInRange(const ObjIndex &corner, const ObjData &attributes) {
+            return corner.Position >= 0 && corner.Position < static_cast<int64_t>(attributes.Positions.size() / 3) &&
+                   corner.TextureCoord >= -1 &&
+                   corner.TextureCoord < static_cast<int64_t>(attributes.TextureCoords.size() / 2) &&
+                   corner.Normal >= -1 && corner.Normal < static_cast<int64_t>(attributes.Normals.size() / 3);
+        }
+
+        // Splits quads along the shorter diagonal, matching tinyobj, everything else is a fan
+        ObjIndex *Triangulate(const std::vector<float> &positions, const ObjIndex *face,
+                              std::span<const uint32_t> faceSizes, ObjIndex *output) {
+            for (uint32_t faceSize: faceSizes) {
+                if (faceSize == 4 && SquaredDistance(positions, face[0].Position, face[2].Position) >=
+                                     SquaredDistance(positions, face[1].Position, face[3].Position)) {
+                    for (int k: {0, 1, 3, 1, 2, 3})
+                        *output++ = face[k];
+                } else {
+                    for (uint32_t k = 1; k + 1 < faceSize; k++) {
+                        *output++ = face[0];
+                        *output++ = face[k];
+                        *output++ = face[k + 1];
+                    }
+                }
+
+                face += faceSize;
+            }
+
+            return output;
+        }
+    }
+
+    ObjData ObjParser::Parse(std::span<const std::byte> source, ThreadPool *pool) {
+        const char *begin = reinterpret_cast<const char *>(source.data());
+        const char *end = begin + source.size();
+
+        // The calling thread takes chunks as well
+        size_t threadCount = pool ? pool->GetThreadCount() + 1 : 1;
+        size_t chunkCount = std::clamp<size_t>(source.size() / MIN_CHUNK_SIZE, 1, threadCount);
+        size_t chunkSize = source.size() / chunkCount;
+
+        // Chunk boundaries always sit right after a newline so no record is split
+        std::vector<const char *> boundaries{begin};
+        for (size_t i = 1; i < chunkCount; i++) {
+            const char *boundary = std::max(begin + i * chunkSize, boundaries.back());
+            auto newline = static_cast<const char *>(memchr(boundary, '\n', end - boundary));
+            boundaries.push_back(newline ? newline + 1 : end);
+        }
+        boundaries.push_back(end);
+
+        // One chunk per call, the chunks are already sized for the threads
+        auto forEachChunk = [&](const std::function<void(size_t)> &function) {
+            ParallelFor(pool, chunkCount, 1, [&](size_t first, size_t last) {
+                for (size_t i = first; i < last; i++)
+                    function(i);
+            });
+        };
+
+        std::vector<ObjChunk> chunks(chunkCount);
+        forEachChunk([&](size_t i) {
+            ParseChunk(boundaries[i], boundaries[i + 1], chunks[i]);
+        });
+
+        struct ChunkOffsets {
+            size_t Positions = 0;
+            size_t TextureCoords = 0;
+            size_t Normals = 0;
+            size_t Triangles = 0;
+        };
+
+        std::vector<ChunkOffsets> offsets(chunkCount + 1);
+        for (size_t i = 0; i < chunkCount; i++) {
+            if (!chunks[i].Error.empty())
+                throw std::runtime_error("ObjParser: " + chunks[i].Error);
+
+            offsets[i + 1] = {
+                    offsets[i].Positions + chunks[i].Data.Positions.size(),
+                    offsets[i].TextureCoords + chunks[i].Data.TextureCoords.size(),
+                    offsets[i].Normals + chunks[i].Data.Normals.size(),
+                    offsets[i].Triangles + chunks[i].TriangleCount,
+            };
+        }
+
+        ObjData result{};
+        result.Positions.resize(offsets[chunkCount].Positions);
+        result.TextureCoords.resize(offsets[chunkCount].TextureCoords);
+        result.Normals.resize(offsets[chunkCount].Normals);
+        result.Corners.resize(offsets[chunkCount].Triangles * 3);
+
+        // Attributes first, quad triangulation needs the merged positions
+        forEachChunk([&](size_t i) {
+            const ObjData &data = chunks[i].Data;
+            std::ranges::copy(data.Positions, result.Positions.begin() + offsets[i].Positions);
+            std::ranges::copy(data.TextureCoords, result.TextureCoords.begin() + offsets[i].TextureCoords);
+            std::ranges::copy(data.Normals, result.Normals.begin() + offsets[i].Normals);
+        });
+
+        forEachChunk([&](size_t i) {
+            ObjChunk &chunk = chunks[i];
+            std::vector<ObjIndex> &corners = chunk.Data.Corners;
+
+            for (size_t c = 0; c < corners.size(); c++) {
+                ObjIndex &corner = corners[c];
+                uint8_t mask = chunk.RelativeMasks[c];
+
+                if (mask & RELATIVE_POSITION)
+                    corner.Position += static_cast<int32_t>(offsets[i].Positions / 3);
+                if (mask & RELATIVE_TEXTURE_COORD)
+                    corner.TextureCoord += static_cast<int32_t>(offsets[i].TextureCoords / 2);
+                if (mask & RELATIVE_NORMAL)
+                    corner.Normal += static_cast<int32_t>(offsets[i].Normals / 3);
+
+                if (!IsInRange(corner, result)) {
+                    chunk.Error = "Face index out of range";
+                    return;
+                }
+            }
+
+            Triangulate(result.Positions, corners.data(), chunk.FaceSizes,
+                        result.Corners.data() + offsets[i].Triangles * 3);
+        });
+
+        for (const auto &chunk: chunks) {
+            if (!chunk.Error.empty())
+                throw std::runtime_error("ObjParser: " + chunk.Error);
+        }
+
+        return result;
+    }
+
+    void ObjParser::ParseStream(const std::filesystem::path &path, const TriangleCallback &onTriangles,
+                                size_t windowSize) {
+        // Read once front to back, every window is released once parsed so the mapping never holds the whole file
+        MappedFile file(path, MappedFileAccess::Sequential);
+        std::span<const std::byte> source = file.GetSpan();
+
+        // Attributes accumulate in place, so negative indices resolve against the global counts directly and
+        // only the faces of the current window are kept around
+        ObjChunk chunk{};
+
+        std::vector<ObjIndex> triangles;
+        size_t position = 0;
+
+        while (true) {
+            const char *data = reinterpret_cast<const char *>(source.data());
+            const char *begin = data + position;
+            const char *end = data + std::min(position + windowSize, source.size());
+            bool last = end == data + source.size();
+
+            // Only complete lines are parsed, the trailing partial line starts the next window
+            if (!last) {
+                const char *newline = end;
+                while (newline > begin && newline[-1] != '\n')
+                    newline--;
+
+                // A single record longer than the window extends it to the end of its line
+                if (newline == begin) {
+                    newline = std::find(end, data + source.size(), '\n');
+                    last = newline == data + source.size();
+                    newline += last ? 0 : 1;
+                }
+
+                end = newline;
+            }
+
+            ParseChunk(begin, end, chunk);
+            if (!chunk.Error.empty())
+                throw std::runtime_error("ObjParser: " + chunk.Error);
+
+            for (const ObjIndex &corner: chunk.Data.Corners) {
+                if (!IsInRange(corner, chunk.Data))
+                    throw std::runtime_error("ObjParser: Face index out of range");
+            }
+
+            triangles.resize(chunk.TriangleCount * 3);
+            Triangulate(chunk.Data.Positions, chunk.Data.Corners.data(), chunk.FaceSizes, triangles.data());
+            if (!triangles.empty())
+                onTriangles(chunk.Data, triangles);
+
+            chunk.Data.Corners.clear();
+            chunk.RelativeMasks.clear();
+            chunk.FaceSizes.clear();
+            chunk.TriangleCount = 0;
+
+            file.Release(source.subspan(position, static_cast<size_t>(end - begin)));
+            if (last)
+                break;
+
+            position = static_cast<size_t>(end - data);
+        }
+    }
+} // Haus
@@ -0,0 +1,50 @@
+#ifndef HAUS_OBJPARSER_H
+#define HAUS_OBJPARSER_H
+
+#include "ThreadPool.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <span>
+#include <vector>
+
+namespace Haus {
+
+    // Zero-based attribute indices of one triangle corner, -1 when the face omits that attribute
+    struct ObjIndex {
+        int32_t Position;
+        int32_t TextureCoord;
+        int32_t Normal;
+    };
+
+    struct ObjData {
+        std::vector<float> Positions;     // xyz
+        std::vector<float> TextureCoords; // uv
+        std::vector<float> Normals;       // xyz
+        std::vector<ObjIndex> Corners;    // Three per triangle, polygons are fan triangulated
+    };
+
+    /* Parses Wavefront OBJ geometry (v, vt, vn and f records), spread over the pool when there is one.
+       The input is split into chunks at line boundaries, every chunk is tokenized independently and the
+       results are concatenated in file order, so the output is identical for any thread count. */
+    class ObjParser {
+    public:
+        static constexpr size_t STREAM_WINDOW_SIZE = 1 << 20;
+
+        static ObjData Parse(std::span<const std::byte> source, ThreadPool *pool = nullptr);
+
+        using TriangleCallback = std::function<void(const ObjData &attributes, std::span<const ObjIndex> triangles)>;
+
+        /* Single pass over the file in windows of windowSize bytes, for memory-constrained imports.
+           Only the attributes parsed so far are kept (Corners stays empty), the triangles of every window are
+           handed to onTriangles in file order and dropped afterwards. The attributes are not bounded by the
+           window, faces may refer to any earlier one, so they grow to the size of the whole file. */
+        static void ParseStream(const std::filesystem::path &path, const TriangleCallback &onTriangles,
+                                size_t windowSize = STREAM_WINDOW_SIZE);
+    };
+
+} // Haus
+
+#endif //HAUS_OBJPARSER_H
@@ -0,0 +1,61 @@
+#include "TangentGenerator.h"
+
+#include <cmath>
+
+namespace Haus {
+    namespace {
+        // Any direction perpendicular to the normal, for vertices whose triangles have no usable mapping
+        glm::vec3 GetPerpendicular(const glm::vec3 &normal) {
+            glm::vec3 axis = std::abs(normal.x) < 0.9f ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+            return glm::normalize(glm::cross(axis, normal));
+        }
+
+        glm::vec3 Rescale(const glm::vec3 &direction, float length) {
+            float current = glm::length(direction);
+            return current > 0.0f ? direction * (length / current) : glm::vec3(0.0f);
+        }
+    }
+
+    void TangentGenerator::Generate(MeshData &mesh) {
+        std::vector<glm::vec3> tangents(mesh.Vertices.size(), glm::vec3(0.0f));
+        std::vector<glm::vec3> bitangents(mesh.Vertices.size(), glm::vec3(0.0f));
+
+        for (size_t i = 0; i + 2 < mesh.Indices.size(); i += 3) {
+            uint32_t corners[3] = {mesh.Indices[i], mesh.Indices[i + 1], mesh.Indices[i + 2]};
+            const Vertex &a = mesh.Vertices[corners[0]];
+            const Vertex &b = mesh.Vertices[corners[1]];
+            const Vertex &c = mesh.Vertices[corners[2]];
+
+            glm::vec3 edge1 = b.Position - a.Position;
+            glm::vec3 edge2 = c.Position - a.Position;
+            glm::vec2 delta1 = b.TextureCoord - a.TextureCoord;
+            glm::vec2 delta2 = c.TextureCoord - a.TextureCoord;
+
+            float determinant = delta1.x * delta2.y - delta2.x * delta1.y;
+            if (std::abs(determinant) < 1e-12f)
+                continue;
+
+            /* Solved as is their length is the world size of one texture unit, so they are rescaled to the
+               triangle area to let larger triangles weigh more */
+            float area = glm::length(glm::cross(edge1, edge2));
+            glm::vec3 tangent = Rescale((edge1 * delta2.y - edge2 * delta1.y) / determinant, area);
+            glm::vec3 bitangent = Rescale((edge2 * delta1.x - edge1 * delta2.x) / determinant, area);
+            for (uint32_t corner: corners) {
+                tangents[corner] += tangent;
+                bitangents[corner] += bitangent;
+            }
+        }
+
+        for (size_t i = 0; i < mesh.Vertices.size(); i++) {
+            Vertex &vertex = mesh.Vertices[i];
+            glm::vec3 normal = glm::length(vertex.Normal) > 0.0f ? glm::normalize(vertex.Normal)
+                                                                 : glm::vec3(0.0f, 0.0f, 1.0f);
+
+            glm::vec3 tangent = tangents[i] - normal * glm::dot(normal, tangents[i]);
+            tangent = glm::length(tangent) > 1e-8f ? glm::normalize(tangent) : GetPerpendicular(normal);
+
+            float handedness = glm::dot(glm::cross(normal, tangent), bitangents[i]) < 0.0f ? -1.0f : 1.0f;
+            vertex.Tangent = glm::vec4(tangent, handedness);
+        }
+    }
+} // Haus
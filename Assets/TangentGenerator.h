@@ -0,0 +1,19 @@
+#ifndef HAUS_TANGENTGENERATOR_H
+#define HAUS_TANGENTGENERATOR_H
+
+#include "Mesh.h"
+
+namespace Haus {
+
+    /* Per-vertex tangents for normal mapping. Every triangle contributes the directions of increasing u and v
+       its texture coordinates span, the sums are orthogonalized against the vertex normal and the handedness
+       of the bitangent is stored in w. Vertices on mirrored seams are already split by the welder, since their
+       texture coordinates differ. */
+    class TangentGenerator {
+    public:
+        static void Generate(MeshData &mesh);
+    };
+
+} // Haus
+
+#endif //HAUS_TANGENTGENERATOR_H
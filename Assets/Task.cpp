@@ -0,0 +1,36 @@
+#include "Task.h"
+
+namespace Haus {
+    void TaskQueue::Push(std::coroutine_handle<> handle, std::function<bool()> condition) {
+        std::lock_guard lock(m_Mutex);
+        m_Entries.push_back({handle, std::move(condition)});
+    }
+
+    void TaskQueue::Drain() {
+        std::vector<Entry> entries;
+        {
+            std::lock_guard lock(m_Mutex);
+            entries.swap(m_Entries);
+        }
+
+        // Coroutines resumed here may queue themselves again, those wait for the next Drain
+        std::vector<Entry> waiting;
+        for (Entry &entry: entries) {
+            if (entry.Condition && !entry.Condition()) {
+                waiting.push_back(std::move(entry));
+                continue;
+            }
+
+            entry.Handle.resume();
+        }
+
+        std::lock_guard lock(m_Mutex);
+        m_Entries.insert(m_Entries.begin(), std::make_move_iterator(waiting.begin()),
+                         std::make_move_iterator(waiting.end()));
+    }
+
+    bool TaskQueue::IsEmpty() const {
+        std::lock_guard lock(m_Mutex);
+        return m_Entries.empty();
+    }
+} // Haus
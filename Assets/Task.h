@@ -0,0 +1,315 @@
+#ifndef HAUS_TASK_H
+#define HAUS_TASK_H
+
+#include "ThreadPool.h"
+
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace Haus {
+
+    class TaskCancelled : public std::runtime_error {
+    public:
+        TaskCancelled() : std::runtime_error("Task: cancelled") {}
+    };
+
+    // Shared flag, copies observe the same cancellation
+    class CancellationToken {
+    public:
+        void Cancel() {
+            m_Cancelled->store(true, std::memory_order_relaxed);
+        }
+
+        bool IsCancelled() const {
+            return m_Cancelled->load(std::memory_order_relaxed);
+        }
+
+        void ThrowIfCancelled() const {
+            if (IsCancelled())
+                throw TaskCancelled();
+        }
+
+    private:
+        std::shared_ptr<std::atomic<bool>> m_Cancelled = std::make_shared<std::atomic<bool>>(false);
+    };
+
+    namespace Detail {
+        template<typename T>
+        class TaskPromise;
+
+        // Resumes whoever awaited the task, or nothing for a task that was never awaited
+        struct FinalAwaiter {
+            bool await_ready() const noexcept {
+                return false;
+            }
+
+            template<typename Promise>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+                std::coroutine_handle<> continuation = handle.promise().Continuation;
+                return continuation ? continuation : std::noop_coroutine();
+            }
+
+            void await_resume() const noexcept {}
+        };
+
+        struct TaskPromiseBase {
+            std::coroutine_handle<> Continuation;
+            std::exception_ptr Exception;
+
+            std::suspend_always initial_suspend() const noexcept {
+                return {};
+            }
+
+            FinalAwaiter final_suspend() const noexcept {
+                return {};
+            }
+
+            void unhandled_exception() noexcept {
+                Exception = std::current_exception();
+            }
+        };
+    }
+
+    /* Lazily started coroutine producing a T. Awaiting the task starts it and resumes the awaiting coroutine
+       once it finishes, on whatever thread the task finished on. Exceptions propagate to the awaiter.
+       Top-level tasks are started with Spawn. */
+    template<typename T = void>
+    class [[nodiscard]] Task {
+    public:
+        using promise_type = Detail::TaskPromise<T>;
+
+        explicit Task(std::coroutine_handle<promise_type> handle) : m_Handle(handle) {}
+
+        ~Task() {
+            if (m_Handle)
+                m_Handle.destroy();
+        }
+
+        Task(Task &&other) noexcept: m_Handle(std::exchange(other.m_Handle, nullptr)) {}
+
+        Task &operator=(Task &&other) noexcept {
+            if (this != &other) {
+                if (m_Handle)
+                    m_Handle.destroy();
+                m_Handle = std::exchange(other.m_Handle, nullptr);
+            }
+            return *this;
+        }
+
+        Task(const Task &) = delete;
+
+        Task &operator=(const Task &) = delete;
+
+        auto operator co_await() const noexcept {
+            struct Awaiter {
+                std::coroutine_handle<promise_type> Handle;
+
+                bool await_ready() const noexcept {
+                    return false;
+                }
+
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                    Handle.promise().Continuation = awaiting;
+                    return Handle;
+                }
+
+                T await_resume() {
+                    return Handle.promise().TakeResult();
+                }
+            };
+
+            return Awaiter{m_Handle};
+        }
+
+    private:
+        std::coroutine_handle<promise_type> m_Handle;
+    };
+
+    namespace Detail {
+        template<typename T>
+        class TaskPromise : public TaskPromiseBase {
+        public:
+            Task<T> get_return_object() {
+                return Task<T>(std::coroutine_handle<TaskPromise>::from_promise(*this));
+            }
+
+            template<typename U>
+            void return_value(U &&value) {
+                m_Value.emplace(std::forward<U>(value));
+            }
+
+            T TakeResult() {
+                if (Exception)
+                    std::rethrow_exception(Exception);
+
+                return std::move(*m_Value);
+            }
+
+        private:
+            std::optional<T> m_Value;
+        };
+
+        template<>
+        class TaskPromise<void> : public TaskPromiseBase {
+        public:
+            Task<void> get_return_object() {
+                return Task<void>(std::coroutine_handle<TaskPromise>::from_promise(*this));
+            }
+
+            void return_void() {}
+
+            void TakeResult() {
+                if (Exception)
+                    std::rethrow_exception(Exception);
+            }
+        };
+
+        // Fire-and-forget frame that owns a spawned task, it destroys itself when done
+        struct DetachedTask {
+            struct promise_type {
+                DetachedTask get_return_object() const noexcept {
+                    return {};
+                }
+
+                std::suspend_never initial_suspend() const noexcept {
+                    return {};
+                }
+
+                std::suspend_never final_suspend() const noexcept {
+                    return {};
+                }
+
+                void return_void() const noexcept {}
+
+                void unhandled_exception() const noexcept {
+                    std::terminate();
+                }
+            };
+        };
+
+        template<typename T>
+        DetachedTask RunDetached(Task<T> task, std::promise<T> promise) {
+            try {
+                if constexpr (std::is_void_v<T>) {
+                    co_await task;
+                    promise.set_value();
+                } else {
+                    promise.set_value(co_await task);
+                }
+            } catch (...) {
+                promise.set_exception(std::current_exception());
+            }
+        }
+    }
+
+    // Starts the task on the calling thread, it runs until its first suspension before Spawn returns
+    template<typename T>
+    std::future<T> Spawn(Task<T> task) {
+        std::promise<T> promise;
+        std::future<T> future = promise.get_future();
+        Detail::RunDetached(std::move(task), std::move(promise));
+
+        return future;
+    }
+
+    /* Moves the awaiting coroutine onto a pool thread. Resuming is a cancellation point, a cancelled token
+       throws TaskCancelled from the co_await. */
+    inline auto Schedule(ThreadPool &pool, TaskPriority priority = TaskPriority::Normal,
+                         CancellationToken token = {}) {
+        struct Awaiter {
+            ThreadPool &Pool;
+            TaskPriority Priority;
+            CancellationToken Token;
+
+            bool await_ready() const noexcept {
+                return false;
+            }
+
+            void await_suspend(std::coroutine_handle<> handle) {
+                Pool.Enqueue([handle]() { handle.resume(); }, Priority);
+            }
+
+            void await_resume() const {
+                Token.ThrowIfCancelled();
+            }
+        };
+
+        return Awaiter{pool, priority, std::move(token)};
+    }
+
+    /* Coroutines waiting for a specific thread, which resumes them by calling Drain. The renderer drains its
+       queue once per frame, so tasks hop onto it for work that needs the graphics queue or the command pool. */
+    class TaskQueue {
+    public:
+        // Resumes the awaiting coroutine on the next Drain, a cancellation point like Schedule
+        auto Schedule(CancellationToken token = {}) {
+            struct Awaiter {
+                TaskQueue &Queue;
+                CancellationToken Token;
+
+                bool await_ready() const noexcept {
+                    return false;
+                }
+
+                void await_suspend(std::coroutine_handle<> handle) {
+                    Queue.Push(handle, nullptr);
+                }
+
+                void await_resume() const {
+                    Token.ThrowIfCancelled();
+                }
+            };
+
+            return Awaiter{*this, std::move(token)};
+        }
+
+        /* Resumes the awaiting coroutine on the first Drain at which condition returns true, used to wait for
+           fences without blocking. Not a cancellation point, work already submitted to the GPU has to finish. */
+        auto Until(std::function<bool()> condition) {
+            struct Awaiter {
+                TaskQueue &Queue;
+                std::function<bool()> Condition;
+
+                bool await_ready() const {
+                    return Condition();
+                }
+
+                void await_suspend(std::coroutine_handle<> handle) {
+                    Queue.Push(handle, std::move(Condition));
+                }
+
+                void await_resume() const noexcept {}
+            };
+
+            return Awaiter{*this, std::move(condition)};
+        }
+
+        // Resumes every coroutine queued before the call whose condition holds
+        void Drain();
+
+        bool IsEmpty() const;
+
+    private:
+        struct Entry {
+            std::coroutine_handle<> Handle;
+            std::function<bool()> Condition;
+        };
+
+        void Push(std::coroutine_handle<> handle, std::function<bool()> condition);
+
+        mutable std::mutex m_Mutex;
+        std::vector<Entry> m_Entries;
+    };
+
+} // Haus
+
+#endif //HAUS_TASK_H
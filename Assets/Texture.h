@@ -0,0 +1,51 @@
+#ifndef HAUS_TEXTURE_H
+#define HAUS_TEXTURE_H
+
+#include "Vertex.h"
+
+#include <span>
+#include <vector>
+
+namespace Haus {
+
+    // One mip level, tightly packed rows starting at Offset. Layers of an array follow each other within the level.
+    struct TextureMip {
+        uint64_t Offset;
+        uint64_t Size;
+        uint32_t Width;
+        uint32_t Height;
+    };
+
+    // Non-owning view of GPU-ready texture data, either imported (TextureData) or mapped from the texture cache
+    struct TextureView {
+        vk::Format Format = vk::Format::eUndefined;
+        uint32_t Width = 0;
+        uint32_t Height = 0;
+        uint32_t Layers = 1;
+        std::span<const TextureMip> Mips;
+        std::span<const std::byte> Data;
+    };
+
+    struct TextureData {
+        vk::Format Format = vk::Format::eUndefined;
+        uint32_t Width = 0;
+        uint32_t Height = 0;
+        uint32_t Layers = 1;
+        std::vector<TextureMip> Mips;
+        std::vector<std::byte> Pixels;
+
+        TextureView View() const {
+            return {
+                    .Format = Format,
+                    .Width = Width,
+                    .Height = Height,
+                    .Layers = Layers,
+                    .Mips = Mips,
+                    .Data = Pixels
+            };
+        }
+    };
+
+} // Haus
+
+#endif //HAUS_TEXTURE_H
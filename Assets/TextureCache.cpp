@@ -0,0 +1,126 @@
+#include "TextureCache.h"
+#include "CacheFile.h"
+#include "Hash.h"
+
+#include <cstring>
+
+namespace Haus {
+    namespace {
+        constexpr std::string_view KEY_ENTRY = "HausCacheKey";
+        constexpr std::string_view VERSION_ENTRY = "HausCacheVersion";
+
+        template<typename T>
+        std::optional<T> FindValue(const Ktx2Contents &contents, std::string_view key) {
+            std::optional<std::span<const std::byte>> value = contents.FindValue(key);
+            if (!value || value->size() != sizeof(T))
+                return std::nullopt;
+
+            T result;
+            memcpy(&result, value->data(), sizeof(T));
+            return result;
+        }
+
+        bool IsCurrent(const Ktx2Contents &contents, std::optional<uint64_t> key) {
+            if (FindValue<uint32_t>(contents, VERSION_ENTRY) != TextureCache::VERSION)
+                return false;
+
+            return !key || FindValue<uint64_t>(contents, KEY_ENTRY) == *key;
+        }
+    }
+
+    std::filesystem::path TextureCache::GetCachePath(const std::filesystem::path &source) {
+        std::filesystem::path path = source;
+        path += ".ktx2";
+        return path;
+    }
+
+    uint64_t TextureCache::ComputeKey(const std::filesystem::path &source, const TextureImportOptions &options) {
+        MappedFile file(source, MappedFileAccess::Sequential);
+
+        uint64_t key = Hash64(file.GetSpan());
+        key = HashCombine(key, options.Hash());
+        return HashCombine(key, VERSION);
+    }
+
+    std::optional<CachedTexture> TextureCache::Load(const std::filesystem::path &cachePath,
+                                                    std::optional<uint64_t> key) {
+        return Map(cachePath, [&](const Ktx2Contents &contents) {
+            return IsCurrent(contents, key);
+        });
+    }
+
+    std::optional<CachedTexture> TextureCache::Load(const AssetArchive &archive,
+                                                    const std::filesystem::path &cachePath) {
+        return Unpack(archive, cachePath, [](const Ktx2Contents &contents) {
+            return IsCurrent(contents, std::nullopt);
+        });
+    }
+
+    std::optional<CachedTexture> TextureCache::LoadKtx2(const std::filesystem::path &path) {
+        return Map(path, [](const Ktx2Contents &) { return true; });
+    }
+
+    std::optional<CachedTexture> TextureCache::LoadKtx2(const AssetArchive &archive,
+                                                        const std::filesystem::path &path) {
+        return Unpack(archive, path, [](const Ktx2Contents &) { return true; });
+    }
+
+    void TextureCache::Store(const std::filesystem::path &cachePath, uint64_t key, const TextureView &texture) {
+        uint32_t version = VERSION;
+        const Ktx2KeyValue keyValues[] = {
+                {std::string(KEY_ENTRY), std::as_bytes(std::span(&key, 1))},
+                {std::string(VERSION_ENTRY), std::as_bytes(std::span(&version, 1))},
+                {"KTXwriter", std::as_bytes(std::span("haus-assetc"))},
+        };
+
+        CacheFile::Write(cachePath, [&](std::ofstream &file) {
+            Ktx2::Write(file, texture, keyValues);
+        });
+    }
+
+    std::optional<CachedTexture> TextureCache::Map(const std::filesystem::path &path, const Filter &accept) {
+        std::error_code error;
+        if (!std::filesystem::is_regular_file(path, error))
+            return std::nullopt;
+
+        CachedTexture texture{};
+        // Streaming reads single levels, scattered over the file, and the whole texture is only uploaded once
+        texture.m_File = MappedFile(path, MappedFileAccess::Random);
+        if (!Parse(texture, texture.m_File.GetSpan(), accept))
+            return std::nullopt;
+
+        return texture;
+    }
+
+    std::optional<CachedTexture> TextureCache::Unpack(const AssetArchive &archive, const std::filesystem::path &path,
+                                                      const Filter &accept) {
+        const ArchiveEntry *entry = archive.Find(path.generic_string());
+        if (!entry)
+            return std::nullopt;
+
+        CachedTexture texture{};
+        std::optional<std::span<const std::byte>> file = archive.Read(*entry, texture.m_Storage);
+        if (!file || !Parse(texture, *file, accept))
+            return std::nullopt;
+
+        return texture;
+    }
+
+    bool TextureCache::Parse(CachedTexture &texture, std::span<const std::byte> file, const Filter &accept) {
+        std::optional<Ktx2Contents> contents = Ktx2::Parse(file);
+        if (!contents || !accept(*contents))
+            return false;
+
+        texture.m_Mips = std::move(contents->Mips);
+        texture.m_View = {
+                .Format = contents->Format,
+                .Width = contents->Width,
+                .Height = contents->Height,
+                .Layers = contents->Layers,
+                .Mips = texture.m_Mips,
+                .Data = contents->Data
+        };
+
+        return true;
+    }
+} // Haus
@@ -0,0 +1,71 @@
+#ifndef HAUS_TEXTURECACHE_H
+#define HAUS_TEXTURECACHE_H
+
+#include "AssetArchive.h"
+#include "Texture.h"
+#include "Ktx2.h"
+#include "MappedFile.h"
+#include "TextureImporter.h"
+
+#include <filesystem>
+#include <functional>
+#include <optional>
+
+namespace Haus {
+
+    /* Texture whose pixels live inside a memory-mapped cache file, or an archive entry, the view stays valid for the
+       lifetime of the object and the archive it was loaded from */
+    class CachedTexture {
+    public:
+        const TextureView &View() const {
+            return m_View;
+        }
+
+    private:
+        MappedFile m_File;
+        TextureView m_View;
+        std::vector<TextureMip> m_Mips;
+        // Archive entry that had to be decompressed, stored ones are used straight from the archive's mapping
+        std::vector<std::byte> m_Storage;
+
+        friend class TextureCache;
+    };
+
+    /* Cache of imported textures with their mip chain, stored next to the source as a KTX2 file "<source>.ktx2".
+       Keyed like the mesh cache by the source bytes, the import options and the cache version, which are kept
+       in the key/value data so the entries stay readable by any KTX2 tool. */
+    class TextureCache {
+    public:
+        static constexpr uint32_t VERSION = 2;
+
+        static std::filesystem::path GetCachePath(const std::filesystem::path &source);
+
+        static uint64_t ComputeKey(const std::filesystem::path &source, const TextureImportOptions &options);
+
+        // Without a key any entry of the current version is accepted, for baked assets shipped without their source
+        static std::optional<CachedTexture> Load(const std::filesystem::path &cachePath, std::optional<uint64_t> key);
+
+        // Baked entry packed into an archive, named by its cache path
+        static std::optional<CachedTexture> Load(const AssetArchive &archive, const std::filesystem::path &cachePath);
+
+        // Maps a KTX2 file that did not come from the cache, such as one authored with other tools
+        static std::optional<CachedTexture> LoadKtx2(const std::filesystem::path &path);
+
+        static std::optional<CachedTexture> LoadKtx2(const AssetArchive &archive, const std::filesystem::path &path);
+
+        static void Store(const std::filesystem::path &cachePath, uint64_t key, const TextureView &texture);
+
+    private:
+        using Filter = std::function<bool(const Ktx2Contents &)>;
+
+        static std::optional<CachedTexture> Map(const std::filesystem::path &path, const Filter &accept);
+
+        static std::optional<CachedTexture> Unpack(const AssetArchive &archive, const std::filesystem::path &path,
+                                                   const Filter &accept);
+
+        static bool Parse(CachedTexture &texture, std::span<const std::byte> file, const Filter &accept);
+    };
+
+} // Haus
+
+#endif //HAUS_TEXTURECACHE_H
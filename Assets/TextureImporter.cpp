@@ -0,0 +1,87 @@
+#include "TextureImporter.h"
+#include "Hash.h"
+#include "MappedFile.h"
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb/image.h>
+
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+
+namespace Haus {
+    namespace {
+        constexpr uint32_t CHANNELS = 4;
+        // Rows per job when the work is split over the pool
+        constexpr size_t ROW_GRAIN = 64;
+    }
+
+    uint64_t TextureImportOptions::Hash() const {
+        uint64_t hash = HashMix(FlipVertically ? 1 : 0);
+        hash = HashCombine(hash, GenerateMips ? 1 : 0);
+        hash = HashCombine(hash, static_cast<uint64_t>(Filter));
+        hash = HashCombine(hash, static_cast<uint64_t>(Usage));
+        hash = HashCombine(hash, Hash64(&HeightScale, sizeof(HeightScale)));
+        hash = HashCombine(hash, static_cast<uint64_t>(Compression));
+        return HashCombine(hash, static_cast<uint64_t>(CompressionQuality));
+    }
+
+    uint32_t TextureImporter::GetMipCount(uint32_t width, uint32_t height) {
+        return static_cast<uint32_t>(std::bit_width(std::max(std::max(width, height), 1u)));
+    }
+
+    TextureData TextureImporter::Import(const std::filesystem::path &path, const TextureImportOptions &options,
+                                        ThreadPool *pool) {
+        MappedFile file(path, MappedFileAccess::Sequential);
+
+        // Height maps are read as one grey channel, whatever channels the file has
+        bool heightMap = options.Usage == TextureUsage::HeightToNormal;
+        uint32_t decodedChannels = heightMap ? 1 : CHANNELS;
+
+        int width, height, channels;
+        stbi_uc *pixels = stbi_load_from_memory(reinterpret_cast<const stbi_uc *>(file.GetData()),
+                                                static_cast<int>(file.GetSize()), &width, &height, &channels,
+                                                static_cast<int>(decodedChannels));
+        if (!pixels)
+            throw std::runtime_error("TextureImporter: Failed to load " + path.string());
+
+        TextureData texture{
+                .Format = vk::Format::eR8G8B8A8Srgb,
+                .Width = static_cast<uint32_t>(width),
+                .Height = static_cast<uint32_t>(height),
+        };
+
+        uint64_t size = static_cast<uint64_t>(texture.Width) * texture.Height * decodedChannels;
+        texture.Mips.push_back({0, size, texture.Width, texture.Height});
+        texture.Pixels.resize(size);
+
+        // The flip happens in the copy out of the decoder's buffer instead of as a pass of its own
+        size_t rowSize = static_cast<size_t>(texture.Width) * decodedChannels;
+        ParallelFor(pool, texture.Height, ROW_GRAIN, [&](size_t begin, size_t end) {
+            for (size_t y = begin; y < end; y++) {
+                size_t sourceRow = options.FlipVertically ? texture.Height - 1 - y : y;
+                memcpy(texture.Pixels.data() + y * rowSize, pixels + sourceRow * rowSize, rowSize);
+            }
+        });
+        stbi_image_free(pixels);
+
+        // Derived after the flip, so the normals follow the rows as they are sampled
+        if (heightMap) {
+            texture = NormalMapGenerator::FromHeight({reinterpret_cast<const uint8_t *>(texture.Pixels.data()),
+                                                      texture.Pixels.size()}, texture.Width, texture.Height,
+                                                     options.HeightScale, pool);
+        }
+
+        if (options.GenerateMips)
+            MipGenerator::Generate(texture, options.Filter, pool);
+
+        if (options.Compression != TextureCompression::None)
+            return BlockCompressor::Compress(texture.View(), options.Compression, options.CompressionQuality, pool);
+
+        // Uncompressed normal maps keep the two channels BC5 would
+        if (heightMap)
+            return NormalMapGenerator::KeepRedGreen(texture.View());
+
+        return texture;
+    }
+} // Haus
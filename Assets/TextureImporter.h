@@ -0,0 +1,49 @@
+#ifndef HAUS_TEXTUREIMPORTER_H
+#define HAUS_TEXTUREIMPORTER_H
+
+#include "BlockCompressor.h"
+#include "MipGenerator.h"
+#include "NormalMapGenerator.h"
+#include "Texture.h"
+
+#include <filesystem>
+
+namespace Haus {
+
+    enum class TextureUsage : uint32_t {
+        Color,
+        // Grey height map, imported as a two-channel tangent space normal map (RG8 or BC5)
+        HeightToNormal
+    };
+
+    // Everything that changes the imported result, so it can take part in the cache key
+    struct TextureImportOptions {
+        // OBJ texture coordinates start at the bottom row
+        bool FlipVertically = true;
+        // Build the full mip chain on the CPU, otherwise only level zero is stored and the GPU fills in the rest
+        bool GenerateMips = true;
+        MipFilter Filter = MipFilter::Kaiser;
+        TextureUsage Usage = TextureUsage::Color;
+        // Height of the full range of a height map, in texels
+        float HeightScale = 16.0f;
+        // Applied after the mips are built, compressed textures keep exactly the levels they store
+        TextureCompression Compression = TextureCompression::None;
+        BlockCompressionQuality CompressionQuality = BlockCompressionQuality::Normal;
+
+        uint64_t Hash() const;
+    };
+
+    class TextureImporter {
+    public:
+        static uint32_t GetMipCount(uint32_t width, uint32_t height);
+
+        /* Decodes any format stb_image reads into sRGB RGBA8, or height maps into normals. Everything after the
+           decode itself (the flipped copy, the normals, the mips and block compression) is split over the pool
+           when given one. */
+        static TextureData Import(const std::filesystem::path &path, const TextureImportOptions &options,
+                                  ThreadPool *pool = nullptr);
+    };
+
+} // Haus
+
+#endif //HAUS_TEXTUREIMPORTER_H
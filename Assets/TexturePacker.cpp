@@ -0,0 +1,83 @@
+#include "TexturePacker.h"
+
+#include <cstring>
+#include <stdexcept>
+
+namespace Haus {
+    namespace {
+        bool Fits(const TextureArrayPlan &array, const TextureView &texture, uint32_t maxLayers) {
+            return array.Format == texture.Format && array.Width == texture.Width && array.Height == texture.Height &&
+                   array.MipLevels == texture.Mips.size() && array.Textures.size() < maxLayers;
+        }
+    }
+
+    TexturePacking TexturePacker::Plan(std::span<const TextureView> textures, uint32_t maxLayers) {
+        if (maxLayers == 0)
+            throw std::invalid_argument("TexturePacker: Arrays need at least one layer");
+
+        TexturePacking packing;
+        packing.Slots.reserve(textures.size());
+
+        for (uint32_t texture = 0; texture < textures.size(); texture++) {
+            const TextureView &view = textures[texture];
+            if (view.Layers != 1 || view.Mips.empty())
+                throw std::invalid_argument("TexturePacker: Only single textures with stored levels can be packed");
+
+            // A handful of arrays at most, a linear search is cheaper than hashing the key
+            uint32_t array = 0;
+            while (array < packing.Arrays.size() && !Fits(packing.Arrays[array], view, maxLayers))
+                array++;
+
+            if (array == packing.Arrays.size()) {
+                packing.Arrays.push_back({
+                        .Format = view.Format,
+                        .Width = view.Width,
+                        .Height = view.Height,
+                        .MipLevels = static_cast<uint32_t>(view.Mips.size())
+                });
+            }
+
+            auto layer = static_cast<uint32_t>(packing.Arrays[array].Textures.size());
+            packing.Arrays[array].Textures.push_back(texture);
+            packing.Slots.push_back({array, layer});
+        }
+
+        return packing;
+    }
+
+    TextureData TexturePacker::Build(const TextureArrayPlan &array, std::span<const TextureView> textures,
+                                     ThreadPool *pool) {
+        if (array.Textures.empty())
+            throw std::invalid_argument("TexturePacker: Array has no layers");
+
+        const TextureView &first = textures[array.Textures[0]];
+        TextureData packed{
+                .Format = array.Format,
+                .Width = array.Width,
+                .Height = array.Height,
+                .Layers = static_cast<uint32_t>(array.Textures.size())
+        };
+
+        // Every layer of a level has the size of that level in the first texture
+        uint64_t size = 0;
+        for (uint32_t level = 0; level < array.MipLevels; level++) {
+            const TextureMip &mip = first.Mips[level];
+            packed.Mips.push_back({size, mip.Size * packed.Layers, mip.Width, mip.Height});
+            size += mip.Size * packed.Layers;
+        }
+        packed.Pixels.resize(size);
+
+        ParallelFor(pool, array.Textures.size(), 1, [&](size_t begin, size_t end) {
+            for (size_t layer = begin; layer < end; layer++) {
+                const TextureView &texture = textures[array.Textures[layer]];
+                for (uint32_t level = 0; level < array.MipLevels; level++) {
+                    const TextureMip &mip = texture.Mips[level];
+                    memcpy(packed.Pixels.data() + packed.Mips[level].Offset + layer * mip.Size,
+                           texture.Data.data() + mip.Offset, mip.Size);
+                }
+            }
+        });
+
+        return packed;
+    }
+} // Haus
@@ -0,0 +1,45 @@
+#ifndef HAUS_TEXTUREPACKER_H
+#define HAUS_TEXTUREPACKER_H
+
+#include "Texture.h"
+#include "ThreadPool.h"
+
+namespace Haus {
+
+    // Where a packed texture ended up, the layer is what materials pass to the shader
+    struct TextureSlot {
+        uint32_t Array;
+        uint32_t Layer;
+    };
+
+    // Textures sharing one array image, in layer order
+    struct TextureArrayPlan {
+        vk::Format Format = vk::Format::eUndefined;
+        uint32_t Width = 0;
+        uint32_t Height = 0;
+        uint32_t MipLevels = 0;
+        std::vector<uint32_t> Textures;
+    };
+
+    struct TexturePacking {
+        std::vector<TextureArrayPlan> Arrays;
+        // One slot per packed texture, in the order they were passed in
+        std::vector<TextureSlot> Slots;
+    };
+
+    /* Groups textures of the same format, size and mip count into 2D array images, so every material sampling
+       them is drawn with the same descriptor set and only differs in the layer it pushes. Arrays rather than an
+       atlas, layers keep their own mip chain and block compression without guard bands or bleeding. */
+    class TexturePacker {
+    public:
+        // Arrays are filled in the order textures first appear, none holds more than maxLayers of them
+        static TexturePacking Plan(std::span<const TextureView> textures, uint32_t maxLayers);
+
+        // Copies every level of the planned textures into a single array, level by level
+        static TextureData Build(const TextureArrayPlan &array, std::span<const TextureView> textures,
+                                 ThreadPool *pool);
+    };
+
+} // Haus
+
+#endif //HAUS_TEXTUREPACKER_H
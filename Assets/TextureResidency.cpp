@@ -0,0 +1,114 @@
+#include "TextureResidency.h"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+namespace Haus {
+    TextureResidency::TextureResidency(uint64_t budget) : m_Budget(budget) {}
+
+    uint32_t TextureResidency::Register(std::vector<uint64_t> levelSizes, uint32_t tailMip, uint32_t baseMip,
+                                        uint64_t frame) {
+        if (levelSizes.empty() || tailMip >= levelSizes.size() || baseMip > tailMip)
+            throw std::invalid_argument("TextureResidency: Resident levels out of range");
+
+        Entry entry{
+                .LevelSizes = std::move(levelSizes),
+                .TailMip = tailMip,
+                .BaseMip = baseMip,
+                .LastUse = frame
+        };
+        m_ResidentBytes += GetBytes(entry, baseMip);
+
+        uint32_t texture = m_NextTexture++;
+        m_Entries.emplace(texture, std::move(entry));
+
+        return texture;
+    }
+
+    void TextureResidency::Unregister(uint32_t texture) {
+        auto it = m_Entries.find(texture);
+        if (it == m_Entries.end())
+            return;
+
+        m_ResidentBytes -= GetBytes(it->second, it->second.BaseMip);
+        m_Entries.erase(it);
+    }
+
+    void TextureResidency::Touch(uint32_t texture, uint64_t frame) {
+        m_Entries.at(texture).LastUse = frame;
+    }
+
+    void TextureResidency::SetBaseMip(uint32_t texture, uint32_t baseMip) {
+        Entry &entry = m_Entries.at(texture);
+        m_ResidentBytes = m_ResidentBytes - GetBytes(entry, entry.BaseMip) + GetBytes(entry, baseMip);
+        entry.BaseMip = baseMip;
+    }
+
+    std::optional<std::vector<TextureEviction>> TextureResidency::MakeRoom(uint32_t texture, uint32_t baseMip,
+                                                                          uint64_t frame) {
+        Entry &entry = m_Entries.at(texture);
+        uint64_t current = GetBytes(entry, entry.BaseMip);
+        uint64_t wanted = GetBytes(entry, baseMip);
+
+        std::vector<TextureEviction> evictions;
+        if (wanted > current && !Evict(wanted - current, texture, frame, evictions))
+            return std::nullopt;
+
+        SetBaseMip(texture, baseMip);
+        return evictions;
+    }
+
+    std::vector<TextureEviction> TextureResidency::Trim(uint64_t frame) {
+        std::vector<TextureEviction> evictions;
+        if (m_ResidentBytes <= m_Budget)
+            return evictions;
+
+        // Drops what it can even when the unused textures do not free enough
+        Evict(0, 0, frame, evictions);
+        return evictions;
+    }
+
+    uint64_t TextureResidency::GetBytes(const Entry &entry, uint32_t baseMip) {
+        return std::accumulate(entry.LevelSizes.begin() + baseMip, entry.LevelSizes.end(), uint64_t(0));
+    }
+
+    bool TextureResidency::Evict(uint64_t required, uint32_t keep, uint64_t frame,
+                                 std::vector<TextureEviction> &evictions) {
+        // Textures drawn in the previous frame would only be streamed right back in
+        std::vector<std::pair<uint32_t, Entry *>> candidates;
+        uint64_t droppable = 0;
+        for (auto &[texture, entry]: m_Entries) {
+            if (texture == keep || entry.LastUse + 1 >= frame || entry.BaseMip >= entry.TailMip)
+                continue;
+
+            candidates.emplace_back(texture, &entry);
+            droppable += GetBytes(entry, entry.BaseMip) - GetBytes(entry, entry.TailMip);
+        }
+
+        bool fits = m_ResidentBytes - droppable + required <= m_Budget;
+        if (!fits && required > 0)
+            return false;
+
+        std::sort(candidates.begin(), candidates.end(), [](const auto &a, const auto &b) {
+            return a.second->LastUse < b.second->LastUse;
+        });
+
+        // The finest level is most of a texture's memory, so each one gives up levels until enough is free
+        for (auto &[texture, entry]: candidates) {
+            if (m_ResidentBytes + required <= m_Budget)
+                break;
+
+            uint32_t baseMip = entry->BaseMip;
+            while (baseMip < entry->TailMip &&
+                   m_ResidentBytes - GetBytes(*entry, entry->BaseMip) + GetBytes(*entry, baseMip) + required >
+                   m_Budget)
+                baseMip++;
+
+            evictions.push_back({texture, baseMip});
+            SetBaseMip(texture, baseMip);
+        }
+
+        return fits;
+    }
+} // Haus
@@ -0,0 +1,69 @@
+#ifndef HAUS_TEXTURERESIDENCY_H
+#define HAUS_TEXTURERESIDENCY_H
+
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace Haus {
+
+    // Texture whose resident levels should start at BaseMip, its finer levels are dropped
+    struct TextureEviction {
+        uint32_t Texture;
+        uint32_t BaseMip;
+    };
+
+    /* Bookkeeping of texture memory against a budget. Textures register the size of every mip level and are
+       touched in the frames that draw them. When a finer level does not fit, the least recently used textures
+       give up their finest levels first, down to the tail they always keep. Only decides, the renderer creates
+       the smaller images and streams levels back in once they are wanted again. */
+    class TextureResidency {
+    public:
+        explicit TextureResidency(uint64_t budget);
+
+        // levelSizes holds the bytes of every level, levels from tailMip on are never dropped
+        uint32_t Register(std::vector<uint64_t> levelSizes, uint32_t tailMip, uint32_t baseMip, uint64_t frame);
+
+        void Unregister(uint32_t texture);
+
+        void Touch(uint32_t texture, uint64_t frame);
+
+        void SetBaseMip(uint32_t texture, uint32_t baseMip);
+
+        /* Accounts texture at baseMip and returns the evictions, least recently used first, that make it fit the
+           budget. Textures drawn in the previous frame are kept, nothing changes when it cannot fit. Returned
+           evictions are already accounted, the renderer has to apply them. */
+        std::optional<std::vector<TextureEviction>> MakeRoom(uint32_t texture, uint32_t baseMip, uint64_t frame);
+
+        // Evictions that bring the resident bytes back under the budget, as far as unused textures allow
+        std::vector<TextureEviction> Trim(uint64_t frame);
+
+        void SetBudget(uint64_t budget) { m_Budget = budget; }
+
+        uint64_t GetBudget() const { return m_Budget; }
+
+        uint64_t GetResidentBytes() const { return m_ResidentBytes; }
+
+    private:
+        struct Entry {
+            std::vector<uint64_t> LevelSizes;
+            uint32_t TailMip = 0;
+            uint32_t BaseMip = 0;
+            uint64_t LastUse = 0;
+        };
+
+        static uint64_t GetBytes(const Entry &entry, uint32_t baseMip);
+
+        // Drops levels of unused textures until the resident bytes plus required fit, returns false if they do not
+        bool Evict(uint64_t required, uint32_t keep, uint64_t frame, std::vector<TextureEviction> &evictions);
+
+        uint64_t m_Budget;
+        uint64_t m_ResidentBytes = 0;
+        uint32_t m_NextTexture = 1;
+        std::unordered_map<uint32_t, Entry> m_Entries;
+    };
+
+} // Haus
+
+#endif //HAUS_TEXTURERESIDENCY_H
@@ -0,0 +1,116 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+
+namespace Haus {
+    ThreadPool::ThreadPool(uint32_t threadCount) {
+        if (threadCount == 0)
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+        m_Threads.reserve(threadCount);
+        for (uint32_t i = 0; i < threadCount; i++)
+            m_Threads.emplace_back(&ThreadPool::WorkerLoop, this);
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard lock(m_Mutex);
+            m_Stopping = true;
+        }
+        m_Condition.notify_all();
+
+        for (std::thread &thread: m_Threads)
+            thread.join();
+    }
+
+    void ThreadPool::Enqueue(std::function<void()> job, TaskPriority priority) {
+        {
+            std::lock_guard lock(m_Mutex);
+            m_Jobs[static_cast<size_t>(priority)].push_back(std::move(job));
+        }
+        m_Condition.notify_one();
+    }
+
+    void ThreadPool::WorkerLoop() {
+        while (true) {
+            std::function<void()> job;
+            {
+                std::unique_lock lock(m_Mutex);
+
+                // Highest priority first
+                auto next = [this]() {
+                    auto queue = std::find_if(m_Jobs.rbegin(), m_Jobs.rend(), [](const auto &jobs) {
+                        return !jobs.empty();
+                    });
+                    return queue == m_Jobs.rend() ? nullptr : &*queue;
+                };
+
+                m_Condition.wait(lock, [&]() { return m_Stopping || next() != nullptr; });
+
+                std::deque<std::function<void()>> *jobs = next();
+                if (jobs == nullptr)
+                    return;
+
+                job = std::move(jobs->front());
+                jobs->pop_front();
+            }
+
+            job();
+        }
+    }
+
+    void ParallelFor(ThreadPool *pool, size_t count, size_t grain,
+                     const std::function<void(size_t begin, size_t end)> &body) {
+        grain = std::max<size_t>(grain, 1);
+        size_t chunks = (count + grain - 1) / grain;
+        if (pool == nullptr || chunks <= 1) {
+            if (count > 0)
+                body(0, count);
+            return;
+        }
+
+        // Shared with the helpers, a helper that only starts after the call returned finds no chunk left
+        struct State {
+            std::atomic<size_t> Next{0};
+            size_t Done = 0;
+            std::exception_ptr Exception;
+            std::mutex Mutex;
+            std::condition_variable Condition;
+        };
+
+        auto state = std::make_shared<State>();
+        auto run = [state, count, grain, &body]() {
+            for (size_t begin = state->Next.fetch_add(grain); begin < count; begin = state->Next.fetch_add(grain)) {
+                size_t end = std::min(begin + grain, count);
+
+                std::exception_ptr exception;
+                try {
+                    body(begin, end);
+                } catch (...) {
+                    exception = std::current_exception();
+                }
+
+                std::lock_guard lock(state->Mutex);
+                if (exception && !state->Exception)
+                    state->Exception = exception;
+
+                state->Done += end - begin;
+                if (state->Done == count)
+                    state->Condition.notify_all();
+            }
+        };
+
+        size_t helpers = std::min<size_t>(pool->GetThreadCount(), chunks - 1);
+        for (size_t i = 0; i < helpers; i++)
+            pool->Enqueue(run, TaskPriority::High);
+
+        run();
+
+        std::unique_lock lock(state->Mutex);
+        state->Condition.wait(lock, [&]() { return state->Done == count; });
+
+        if (state->Exception)
+            std::rethrow_exception(state->Exception);
+    }
+} // Haus
@@ -0,0 +1,74 @@
+#ifndef HAUS_THREADPOOL_H
+#define HAUS_THREADPOOL_H
+
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace Haus {
+
+    enum class TaskPriority : uint32_t {
+        Low,
+        Normal,
+        High,
+        Count
+    };
+
+    /* Fixed set of worker threads. Jobs of a higher priority always run first, jobs of the same priority in
+       submission order. The destructor drains the queue. */
+    class ThreadPool {
+    public:
+        // Zero picks one thread per hardware thread
+        explicit ThreadPool(uint32_t threadCount = 0);
+
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool &) = delete;
+
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        uint32_t GetThreadCount() const {
+            return static_cast<uint32_t>(m_Threads.size());
+        }
+
+        void Enqueue(std::function<void()> job, TaskPriority priority = TaskPriority::Normal);
+
+        // Exceptions thrown by the job are rethrown by the future
+        template<typename F>
+        auto Submit(F &&function, TaskPriority priority = TaskPriority::Normal) -> std::future<std::invoke_result_t<F>> {
+            using Result = std::invoke_result_t<F>;
+
+            // std::function needs a copyable target, the task itself is move-only
+            auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(function));
+            std::future<Result> future = task->get_future();
+            Enqueue([task]() { (*task)(); }, priority);
+
+            return future;
+        }
+
+    private:
+        void WorkerLoop();
+
+        std::vector<std::thread> m_Threads;
+        std::array<std::deque<std::function<void()>>, static_cast<size_t>(TaskPriority::Count)> m_Jobs;
+        std::mutex m_Mutex;
+        std::condition_variable m_Condition;
+        bool m_Stopping = false;
+    };
+
+    /* Calls body on chunks of at most grain items covering [0, count), spread over the pool and the calling
+       thread, and returns once every chunk is done. The caller takes chunks itself, so this is safe inside a
+       pool job. Without a pool everything runs on the calling thread. The first exception is rethrown. */
+    void ParallelFor(ThreadPool *pool, size_t count, size_t grain,
+                     const std::function<void(size_t begin, size_t end)> &body);
+
+} // Haus
+
+#endif //HAUS_THREADPOOL_H
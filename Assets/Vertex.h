@@ -0,0 +1,30 @@
+#ifndef HAUS_VERTEX_H
+#define HAUS_VERTEX_H
+
+#define VULKAN_HPP_NO_CONSTRUCTORS
+
+#include <vulkan/vulkan.hpp>
+#include <span>
+#include <vector>
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+
+#include <glm/glm.hpp>
+
+
+struct Vertex {
+    glm::vec3 Position;
+    glm::vec3 Color;
+    glm::vec2 TextureCoord;
+    glm::vec3 Normal;
+    // Direction of increasing u, w is the handedness: bitangent = cross(Normal, Tangent.xyz) * w
+    glm::vec4 Tangent;
+
+    bool operator==(const Vertex &other) const {
+        return Position == other.Position && Color == other.Color && TextureCoord == other.TextureCoord &&
+               Normal == other.Normal && Tangent == other.Tangent;
+    }
+};
+
+#endif //HAUS_VERTEX_H
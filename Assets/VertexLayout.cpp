@@ -0,0 +1,346 @@
+#include "VertexLayout.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstring>
+
+namespace Haus {
+    namespace {
+        // Indices match the shader input locations
+        enum AttributeIndex : uint32_t {
+            POSITION,
+            COLOR,
+            TEXTURE_COORD,
+            NORMAL,
+            TANGENT,
+            ATTRIBUTE_COUNT
+        };
+
+        struct AttributePlacement {
+            bool Present;
+            uint32_t Stream;
+            uint32_t Offset;
+            uint32_t Size;
+            vk::Format Format;
+        };
+
+        using AttributePlacements = std::array<AttributePlacement, ATTRIBUTE_COUNT>;
+
+        /* Interleaved fp32 follows the Vertex struct, packed layouts put the position first, then the normal,
+           tangent, texture coordinate and color. Deinterleaved layouts keep that order within each stream. */
+        AttributePlacements GetPlacements(const VertexLayout &layout) {
+            bool packed = layout.IsPacked();
+            vk::Format positionFormat = layout.Position == VertexPositionFormat::Snorm16 ? vk::Format::eR16G16B16A16Snorm
+                                                                                         : vk::Format::eR16G16B16A16Sfloat;
+
+            AttributePlacements placements{};
+            placements[POSITION] = {true, 0, 0, packed ? 8u : 12u, packed ? positionFormat : vk::Format::eR32G32B32Sfloat};
+            placements[COLOR] = {layout.HasColor(), 2, 0, packed ? 4u : 12u,
+                                 packed ? vk::Format::eR8G8B8A8Unorm : vk::Format::eR32G32B32Sfloat};
+            placements[TEXTURE_COORD] = {true, 1, 0, packed ? 4u : 8u,
+                                         packed ? vk::Format::eR16G16Unorm : vk::Format::eR32G32Sfloat};
+            placements[NORMAL] = {true, 1, 0, packed ? 4u : 12u,
+                                  packed ? vk::Format::eR16G16Snorm : vk::Format::eR32G32B32Sfloat};
+            placements[TANGENT] = {true, 1, 0, packed ? 4u : 16u,
+                                   packed ? vk::Format::eR8G8B8A8Snorm : vk::Format::eR32G32B32A32Sfloat};
+
+            constexpr AttributeIndex VERTEX_ORDER[] = {POSITION, COLOR, TEXTURE_COORD, NORMAL, TANGENT};
+            constexpr AttributeIndex PACKED_ORDER[] = {POSITION, NORMAL, TANGENT, TEXTURE_COORD, COLOR};
+
+            uint32_t streamOffsets[VertexLayout::MAX_STREAMS]{};
+            for (AttributeIndex attribute: layout.IsVertexStruct() ? VERTEX_ORDER : PACKED_ORDER) {
+                AttributePlacement &placement = placements[attribute];
+                if (!placement.Present)
+                    continue;
+
+                if (!layout.Deinterleaved)
+                    placement.Stream = 0;
+                else if (placement.Stream == 2 && !layout.HasColor())
+                    continue;
+
+                placement.Offset = streamOffsets[placement.Stream];
+                streamOffsets[placement.Stream] += placement.Size;
+            }
+
+            return placements;
+        }
+
+        bool IsRead(AttributeIndex attribute, const VertexShaderInputs &inputs) {
+            switch (attribute) {
+                case COLOR:
+                    return inputs.Color;
+                case TEXTURE_COORD:
+                    return inputs.TextureCoord;
+                case NORMAL:
+                    return inputs.Normal;
+                case TANGENT:
+                    return inputs.Tangent;
+                default:
+                    return true;
+            }
+        }
+
+        int16_t ToSnorm16(float value) {
+            return static_cast<int16_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+        }
+
+        uint16_t ToUnorm16(float value) {
+            return static_cast<uint16_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 65535.0f));
+        }
+
+        int8_t ToSnorm8(float value) {
+            return static_cast<int8_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 127.0f));
+        }
+
+        uint8_t ToUnorm8(float value) {
+            return static_cast<uint8_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+        }
+
+        float SignNotZero(float value) {
+            return value >= 0.0f ? 1.0f : -1.0f;
+        }
+
+        // Guards against flat meshes, a zero scale would make every packed component meaningless
+        float SafeScale(float extent) {
+            return extent > 0.0f ? extent : 1.0f;
+        }
+    }
+
+    uint32_t VertexLayout::GetStride() const {
+        uint32_t stride = 0;
+        for (const AttributePlacement &placement: GetPlacements(*this))
+            stride += placement.Present ? placement.Size : 0;
+
+        return stride;
+    }
+
+    uint32_t VertexLayout::GetStreamCount() const {
+        if (!Deinterleaved)
+            return 1;
+
+        return HasColor() ? 3 : 2;
+    }
+
+    uint32_t VertexLayout::GetStreamStride(uint32_t stream) const {
+        uint32_t stride = 0;
+        for (const AttributePlacement &placement: GetPlacements(*this))
+            stride += placement.Present && placement.Stream == stream ? placement.Size : 0;
+
+        return stride;
+    }
+
+    uint64_t VertexLayout::GetStreamOffset(uint32_t stream, uint32_t vertexCount) const {
+        // Tightly packed, every stream stride is a multiple of the component sizes it holds
+        uint64_t offset = 0;
+        for (uint32_t previous = 0; previous < stream; previous++)
+            offset += static_cast<uint64_t>(GetStreamStride(previous)) * vertexCount;
+
+        return offset;
+    }
+
+    const char *VertexLayout::GetShaderVariant() const {
+        if (!IsPacked())
+            return "";
+
+        return Color ? "_packed_color" : "_packed";
+    }
+
+    std::vector<vk::VertexInputBindingDescription> VertexLayout::GetBindingDescriptions(
+            const VertexShaderInputs &inputs) const {
+        AttributePlacements placements = GetPlacements(*this);
+
+        std::vector<vk::VertexInputBindingDescription> bindingDescriptions;
+        for (uint32_t stream = 0; stream < GetStreamCount(); stream++) {
+            bool used = false;
+            for (uint32_t attribute = 0; attribute < ATTRIBUTE_COUNT; attribute++) {
+                used |= placements[attribute].Present && placements[attribute].Stream == stream &&
+                        IsRead(static_cast<AttributeIndex>(attribute), inputs);
+            }
+
+            if (used) {
+                bindingDescriptions.push_back({
+                        .binding = stream,
+                        .stride = GetStreamStride(stream),
+                        .inputRate = vk::VertexInputRate::eVertex
+                });
+            }
+        }
+
+        return bindingDescriptions;
+    }
+
+    std::vector<vk::VertexInputAttributeDescription> VertexLayout::GetAttributeDescriptions(
+            const VertexShaderInputs &inputs) const {
+        AttributePlacements placements = GetPlacements(*this);
+
+        std::vector<vk::VertexInputAttributeDescription> attributeDescriptions;
+        for (uint32_t attribute = 0; attribute < ATTRIBUTE_COUNT; attribute++) {
+            const AttributePlacement &placement = placements[attribute];
+            if (!placement.Present || !IsRead(static_cast<AttributeIndex>(attribute), inputs))
+                continue;
+
+            attributeDescriptions.push_back({
+                    .location = attribute,
+                    .binding = placement.Stream,
+                    .format = placement.Format,
+                    .offset = placement.Offset
+            });
+        }
+
+        return attributeDescriptions;
+    }
+
+    glm::vec2 VertexPacker::EncodeOctahedron(glm::vec3 normal) {
+        float length = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+        if (length == 0.0f)
+            return {0.0f, 0.0f};
+
+        normal /= length;
+        if (normal.z >= 0.0f)
+            return {normal.x, normal.y};
+
+        return {(1.0f - std::abs(normal.y)) * SignNotZero(normal.x),
+                (1.0f - std::abs(normal.x)) * SignNotZero(normal.y)};
+    }
+
+    glm::vec3 VertexPacker::DecodeOctahedron(glm::vec2 encoded) {
+        glm::vec3 normal{encoded.x, encoded.y, 1.0f - std::abs(encoded.x) - std::abs(encoded.y)};
+        if (normal.z < 0.0f) {
+            float x = normal.x;
+            normal.x = (1.0f - std::abs(normal.y)) * SignNotZero(x);
+            normal.y = (1.0f - std::abs(x)) * SignNotZero(normal.y);
+        }
+
+        return glm::normalize(normal);
+    }
+
+    uint16_t VertexPacker::FloatToHalf(float value) {
+        auto bits = std::bit_cast<uint32_t>(value);
+        uint32_t sign = (bits >> 16) & 0x8000;
+        uint32_t exponent = (bits >> 23) & 0xFF;
+        uint32_t mantissa = bits & 0x7FFFFF;
+
+        if (exponent == 0xFF)
+            return static_cast<uint16_t>(sign | 0x7C00 | (mantissa ? 0x200 : 0));
+
+        int32_t halfExponent = static_cast<int32_t>(exponent) - 127 + 15;
+        if (halfExponent >= 0x1F)
+            return static_cast<uint16_t>(sign | 0x7C00);
+
+        if (halfExponent <= 0) {
+            // Denormal or zero, round to nearest even on the shifted mantissa
+            if (halfExponent < -10)
+                return static_cast<uint16_t>(sign);
+
+            mantissa |= 0x800000;
+            uint32_t shift = static_cast<uint32_t>(14 - halfExponent);
+            uint32_t half = mantissa >> shift;
+            uint32_t remainder = mantissa & ((1u << shift) - 1);
+            uint32_t midpoint = 1u << (shift - 1);
+            if (remainder > midpoint || (remainder == midpoint && (half & 1)))
+                half++;
+            return static_cast<uint16_t>(sign | half);
+        }
+
+        uint32_t half = (static_cast<uint32_t>(halfExponent) << 10) | (mantissa >> 13);
+        uint32_t remainder = mantissa & 0x1FFF;
+        if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1)))
+            half++; // May carry into the exponent, which is still the correctly rounded value
+
+        return static_cast<uint16_t>(sign | half);
+    }
+
+    PackedVertices VertexPacker::Pack(std::span<const Vertex> vertices, const VertexLayout &layout) {
+        PackedVertices packed{};
+        if (layout.IsVertexStruct() || vertices.empty())
+            return packed;
+
+        glm::vec3 positionMin = vertices[0].Position;
+        glm::vec3 positionMax = vertices[0].Position;
+        glm::vec2 textureCoordMin = vertices[0].TextureCoord;
+        glm::vec2 textureCoordMax = vertices[0].TextureCoord;
+        for (const Vertex &vertex: vertices) {
+            positionMin = glm::min(positionMin, vertex.Position);
+            positionMax = glm::max(positionMax, vertex.Position);
+            textureCoordMin = glm::min(textureCoordMin, vertex.TextureCoord);
+            textureCoordMax = glm::max(textureCoordMax, vertex.TextureCoord);
+        }
+
+        glm::vec3 center = (positionMin + positionMax) * 0.5f;
+        glm::vec3 halfExtent = (positionMax - positionMin) * 0.5f;
+        glm::vec3 positionScale{SafeScale(halfExtent.x), SafeScale(halfExtent.y), SafeScale(halfExtent.z)};
+        glm::vec2 textureCoordScale{SafeScale(textureCoordMax.x - textureCoordMin.x),
+                                    SafeScale(textureCoordMax.y - textureCoordMin.y)};
+
+        // fp32 streams are not quantized, the identity transform keeps the push constants meaningful
+        if (layout.IsPacked()) {
+            packed.Quantization = {
+                    .PositionOffset = glm::vec4(center, 0.0f),
+                    .PositionScale = glm::vec4(positionScale, 1.0f),
+                    .TextureCoordTransform = {textureCoordMin.x, textureCoordMin.y, textureCoordScale.x,
+                                              textureCoordScale.y},
+            };
+        }
+
+        auto vertexCount = static_cast<uint32_t>(vertices.size());
+        packed.Data.resize(static_cast<size_t>(layout.GetStride()) * vertexCount);
+
+        AttributePlacements placements = GetPlacements(layout);
+        std::byte *streams[VertexLayout::MAX_STREAMS];
+        uint32_t strides[VertexLayout::MAX_STREAMS];
+        for (uint32_t stream = 0; stream < layout.GetStreamCount(); stream++) {
+            streams[stream] = packed.Data.data() + layout.GetStreamOffset(stream, vertexCount);
+            strides[stream] = layout.GetStreamStride(stream);
+        }
+
+        auto output = [&](AttributeIndex attribute, size_t vertex) {
+            const AttributePlacement &placement = placements[attribute];
+            return streams[placement.Stream] + vertex * strides[placement.Stream] + placement.Offset;
+        };
+
+        for (size_t i = 0; i < vertices.size(); i++) {
+            const Vertex &vertex = vertices[i];
+
+            if (!layout.IsPacked()) {
+                memcpy(output(POSITION, i), &vertex.Position, sizeof(vertex.Position));
+                memcpy(output(COLOR, i), &vertex.Color, sizeof(vertex.Color));
+                memcpy(output(TEXTURE_COORD, i), &vertex.TextureCoord, sizeof(vertex.TextureCoord));
+                memcpy(output(NORMAL, i), &vertex.Normal, sizeof(vertex.Normal));
+                memcpy(output(TANGENT, i), &vertex.Tangent, sizeof(vertex.Tangent));
+                continue;
+            }
+
+            glm::vec3 position = (vertex.Position - center) / positionScale;
+            uint16_t positionBits[4]{};
+            for (int c = 0; c < 3; c++) {
+                positionBits[c] = layout.Position == VertexPositionFormat::Snorm16
+                                  ? static_cast<uint16_t>(ToSnorm16(position[c]))
+                                  : FloatToHalf(std::clamp(position[c], -1.0f, 1.0f));
+            }
+            memcpy(output(POSITION, i), positionBits, sizeof(positionBits));
+
+            glm::vec2 octahedron = EncodeOctahedron(vertex.Normal);
+            int16_t normal[2] = {ToSnorm16(octahedron.x), ToSnorm16(octahedron.y)};
+            memcpy(output(NORMAL, i), normal, sizeof(normal));
+
+            int8_t tangent[4] = {ToSnorm8(vertex.Tangent.x), ToSnorm8(vertex.Tangent.y), ToSnorm8(vertex.Tangent.z),
+                                 ToSnorm8(vertex.Tangent.w)};
+            memcpy(output(TANGENT, i), tangent, sizeof(tangent));
+
+            uint16_t textureCoord[2] = {
+                    ToUnorm16((vertex.TextureCoord.x - textureCoordMin.x) / textureCoordScale.x),
+                    ToUnorm16((vertex.TextureCoord.y - textureCoordMin.y) / textureCoordScale.y),
+            };
+            memcpy(output(TEXTURE_COORD, i), textureCoord, sizeof(textureCoord));
+
+            if (layout.Color) {
+                uint8_t color[4] = {ToUnorm8(vertex.Color.r), ToUnorm8(vertex.Color.g), ToUnorm8(vertex.Color.b), 255};
+                memcpy(output(COLOR, i), color, sizeof(color));
+            }
+        }
+
+        return packed;
+    }
+} // Haus
@@ -0,0 +1,96 @@
+#ifndef HAUS_VERTEXLAYOUT_H
+#define HAUS_VERTEXLAYOUT_H
+
+#include "Vertex.h"
+
+namespace Haus {
+
+    enum class VertexPositionFormat : uint32_t {
+        Float32, // The full fp32 Vertex, normals and texture coordinates stay fp32 as well
+        Snorm16,
+        Float16
+    };
+
+    // Attributes a vertex shader reads besides the position, pipelines only bind the streams these need
+    struct VertexShaderInputs {
+        bool Color = true;
+        bool TextureCoord = true;
+        bool Normal = true;
+        bool Tangent = true;
+    };
+
+    /* Vertex layout of a mesh on the GPU. Packed layouts store the position as four 16-bit components
+       normalized to the mesh bounds, the normal octahedron-encoded as snorm16x2, the tangent with its handedness
+       as snorm8x4, texture coordinates as unorm16x2 normalized to the UV bounds and optionally the color as
+       unorm8x4. The fp32 layout always carries the color.
+
+       Deinterleaved layouts split the vertex buffer into streams, each with its own binding: the position,
+       normal, tangent and texture coordinate, and the color. Streams are stored back to back, so a depth-only pass
+       fetches nothing but positions. */
+    struct VertexLayout {
+        static constexpr uint32_t MAX_STREAMS = 3;
+
+        VertexPositionFormat Position = VertexPositionFormat::Float32;
+        bool Color = true;
+        bool Deinterleaved = false;
+
+        bool IsPacked() const {
+            return Position != VertexPositionFormat::Float32;
+        }
+
+        // The layout is the Vertex struct itself, so imported vertices are uploaded as they are
+        bool IsVertexStruct() const {
+            return !IsPacked() && !Deinterleaved;
+        }
+
+        bool HasColor() const {
+            return Color || !IsPacked();
+        }
+
+        // Bytes per vertex summed over all streams
+        uint32_t GetStride() const;
+
+        uint32_t GetStreamCount() const;
+
+        uint32_t GetStreamStride(uint32_t stream) const;
+
+        // Offset of a stream in the vertex buffer, which is GetStride() * vertexCount bytes in total
+        uint64_t GetStreamOffset(uint32_t stream, uint32_t vertexCount) const;
+
+        // Suffix of the vertex shader compiled for this layout, "shaders/vert<variant>.spv"
+        const char *GetShaderVariant() const;
+
+        // Binding n always holds stream n, streams none of the inputs read are left out
+        std::vector<vk::VertexInputBindingDescription> GetBindingDescriptions(const VertexShaderInputs &inputs = {}) const;
+
+        std::vector<vk::VertexInputAttributeDescription> GetAttributeDescriptions(const VertexShaderInputs &inputs = {}) const;
+
+        bool operator==(const VertexLayout &other) const = default;
+    };
+
+    // Dequantization of packed vertices: value = offset + scale * stored, laid out to match the vertex push constants
+    struct VertexQuantization {
+        glm::vec4 PositionOffset{0.0f};
+        glm::vec4 PositionScale{1.0f};
+        glm::vec4 TextureCoordTransform{0.0f, 0.0f, 1.0f, 1.0f}; // xy offset, zw scale
+    };
+
+    struct PackedVertices {
+        std::vector<std::byte> Data;
+        VertexQuantization Quantization;
+    };
+
+    class VertexPacker {
+    public:
+        static PackedVertices Pack(std::span<const Vertex> vertices, const VertexLayout &layout);
+
+        static glm::vec2 EncodeOctahedron(glm::vec3 normal);
+
+        static glm::vec3 DecodeOctahedron(glm::vec2 encoded);
+
+        static uint16_t FloatToHalf(float value);
+    };
+
+} // Haus
+
+#endif //HAUS_VERTEXLAYOUT_H
@@ -0,0 +1,66 @@
+#include "VertexWelder.h"
+#include "Hash.h"
+
+#include <bit>
+
+namespace Haus {
+    static_assert(sizeof(Vertex) == 15 * sizeof(float), "Vertex must not contain padding, it is hashed by its bytes");
+
+    VertexWelder::VertexWelder(size_t expectedVertices) {
+        // Keep the load factor at or below one half
+        size_t capacity = std::bit_ceil(std::max<size_t>(expectedVertices * 2, 64));
+        m_Slots.assign(capacity, {0, EMPTY});
+        m_Mask = capacity - 1;
+        m_Vertices.reserve(expectedVertices);
+    }
+
+    uint32_t VertexWelder::HashVertex(const Vertex &vertex) {
+        uint64_t hash = Hash64(&vertex, sizeof(Vertex));
+        return static_cast<uint32_t>(hash ^ (hash >> 32));
+    }
+
+    uint32_t VertexWelder::Weld(const Vertex &vertex) {
+        uint32_t hash = HashVertex(vertex);
+        m_Stats.Lookups++;
+
+        for (size_t position = hash & m_Mask;; position = (position + 1) & m_Mask) {
+            Slot &slot = m_Slots[position];
+            m_Stats.Probes++;
+
+            if (slot.Index == EMPTY) {
+                slot = {hash, static_cast<uint32_t>(m_Vertices.size())};
+                m_Vertices.push_back(vertex);
+
+                uint32_t index = slot.Index;
+                if (m_Vertices.size() * 2 > m_Slots.size())
+                    Grow();
+
+                return index;
+            }
+
+            if (slot.Hash == hash && memcmp(&m_Vertices[slot.Index], &vertex, sizeof(Vertex)) == 0) {
+                m_Stats.Hits++;
+                return slot.Index;
+            }
+        }
+    }
+
+    void VertexWelder::Grow() {
+        std::vector<Slot> slots(m_Slots.size() * 2, {0, EMPTY});
+        size_t mask = slots.size() - 1;
+
+        for (const Slot &slot: m_Slots) {
+            if (slot.Index == EMPTY)
+                continue;
+
+            size_t position = slot.Hash & mask;
+            while (slots[position].Index != EMPTY)
+                position = (position + 1) & mask;
+
+            slots[position] = slot;
+        }
+
+        m_Slots = std::move(slots);
+        m_Mask = mask;
+    }
+} // Haus
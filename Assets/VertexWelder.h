@@ -0,0 +1,56 @@
+#ifndef HAUS_VERTEXWELDER_H
+#define HAUS_VERTEXWELDER_H
+
+#include "Mesh.h"
+
+namespace Haus {
+
+    struct VertexWelderStats {
+        uint64_t Lookups = 0;
+        uint64_t Hits = 0;
+        uint64_t Probes = 0;
+    };
+
+    /* Deduplicates vertices by their exact bytes using a flat open-addressing table with linear probing.
+       Every lookup either finds the existing vertex or claims the empty slot it stopped at, so each corner
+       costs a single probe sequence. */
+    class VertexWelder {
+    public:
+        explicit VertexWelder(size_t expectedVertices = 0);
+
+        // Returns the index of an identical vertex, appending the vertex if it has not been seen before
+        uint32_t Weld(const Vertex &vertex);
+
+        const std::vector<Vertex> &GetVertices() const {
+            return m_Vertices;
+        }
+
+        std::vector<Vertex> TakeVertices() {
+            return std::move(m_Vertices);
+        }
+
+        const VertexWelderStats &GetStats() const {
+            return m_Stats;
+        }
+
+    private:
+        struct Slot {
+            uint32_t Hash;
+            uint32_t Index;
+        };
+
+        static constexpr uint32_t EMPTY = UINT32_MAX;
+
+        static uint32_t HashVertex(const Vertex &vertex);
+
+        void Grow();
+
+        std::vector<Slot> m_Slots;
+        std::vector<Vertex> m_Vertices;
+        size_t m_Mask = 0;
+        VertexWelderStats m_Stats;
+    };
+
+} // Haus
+
+#endif //HAUS_VERTEXWELDER_H
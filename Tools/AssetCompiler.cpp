@@ -0,0 +1,25 @@
+#include <chrono>
+#include <format>
+#include <iostream>
+#include "Assets/AssetCompiler.h"
+
+int main(int argc, char **argv) {
+    if (argc != 3) {
+        std::cerr << "Usage: haus-assetc <source directory> <output directory>" << std::endl;
+        return 1;
+    }
+
+    try {
+        auto start = std::chrono::steady_clock::now();
+        Haus::AssetCompilerStats stats = Haus::AssetCompiler::Compile(argv[1], argv[2]);
+        auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << std::format("Baked {} assets, {} up to date, {} copied, {} packed in {:.2f}s",
+                                 stats.Compiled, stats.UpToDate, stats.Copied, stats.Packed, elapsed) << std::endl;
+    } catch (std::exception &exception) {
+        std::cerr << exception.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -19,17 +19,24 @@ namespace Haus {
         if (devices.empty())
             throw std::runtime_error("Failed to find GPUs with vulkan support");
 
+        // A device sampling BC formats is preferred, the others fall back to uncompressed textures
         for (const auto &device: devices) {
-            if (IsDeviceSuitable(device)) {
-                m_PhysicalDevice = device;
+            if (!IsDeviceSuitable(device))
+                continue;
 
-                break;
+            bool blockCompression = device.getFeatures().textureCompressionBC;
+            if (m_PhysicalDevice == VK_NULL_HANDLE || (blockCompression && !m_BlockCompression)) {
+                m_PhysicalDevice = device;
+                m_BlockCompression = blockCompression;
             }
         }
 
         if (m_PhysicalDevice == VK_NULL_HANDLE)
             throw std::runtime_error("Failed to find a suitable GPU!");
 
+        if (!m_BlockCompression)
+            std::cout << "BC texture compression is not supported, textures are loaded uncompressed" << "\n";
+
         vk::PhysicalDeviceProperties deviceProperties = m_PhysicalDevice.getProperties();
         std::cout << deviceProperties.deviceName << "\n";
         std::cout << to_string(deviceProperties.deviceType) << "\n";
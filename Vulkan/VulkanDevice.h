@@ -22,8 +22,14 @@ namespace Haus {
             return m_PhysicalDevice;
         }
 
+        // Whether BC formats can be sampled, textures are loaded uncompressed otherwise
+        bool SupportsBlockCompression() const {
+            return m_BlockCompression;
+        }
+
     private:
         vk::PhysicalDevice m_PhysicalDevice;
+        bool m_BlockCompression = false;
 
         friend class VulkanDevice;
     };
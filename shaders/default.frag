@@ -4,13 +4,35 @@ layout (location = 0) in vec3 fragColor;
 layout (location = 1) in vec2 textureCoord;
 layout (location = 2) in vec3 normal;
 layout (location = 3) in vec3 fragPos;
+layout (location = 4) in vec4 tangent;
 
 layout (location = 0) out vec4 FragColor;
 
-layout (set = 0, binding = 1) uniform sampler2D textureSampler;
+// Layers of the material being drawn, behind the vertex shader's part of the block
+layout (push_constant) uniform Constants {
+    layout (offset = 64) uint colorLayer;
+    uint normalMapLayer;
+} constants;
+
+// Textures of every material, one layer each
+layout (set = 0, binding = 1) uniform sampler2DArray textureSampler;
+// Tangent space x and y, z is rebuilt since the normal has unit length
+layout (set = 0, binding = 2) uniform sampler2DArray normalSampler;
+
+vec3 SampleNormal() {
+    vec3 n = normalize(normal);
+    vec3 t = normalize(tangent.xyz - n * dot(n, tangent.xyz));
+    vec3 b = cross(n, t) * tangent.w;
+
+    vec3 tangentNormal;
+    tangentNormal.xy = texture(normalSampler, vec3(textureCoord, constants.normalMapLayer)).rg * 2.0 - 1.0;
+    tangentNormal.z = sqrt(max(1.0 - dot(tangentNormal.xy, tangentNormal.xy), 0.0));
+    return normalize(mat3(t, b, n) * tangentNormal);
+}
 
 void main() {
-    vec3 norm = normalize(normal);
+    vec3 norm = SampleNormal();
+    vec4 color = texture(textureSampler, vec3(textureCoord, constants.colorLayer));
     vec3 viewDirection = normalize(vec3(0.0f, 0.0f, 3.0f) - fragPos);
 
     vec3 lightDirection = normalize(-vec3(-0.2f, -1.0f, -0.3f));
@@ -20,11 +42,11 @@ void main() {
 
     // Specular Shading
     vec3 halfwayDirection = normalize(lightDirection + viewDirection);
-    float spec = pow(max(dot(normal, halfwayDirection), 0.0), 2.0);
+    float spec = pow(max(dot(norm, halfwayDirection), 0.0), 2.0);
 
-    vec4 ambient = vec4(0.025, 0.025, 0.025, 1.0) * texture(textureSampler, textureCoord);
-    vec4 diffuse = vec4(1.0, 1.0, 1.0, 1.0) * diff * texture(textureSampler, textureCoord);
-    vec4 specular = vec4(1.0, 1.0, 1.0, 1.0) * spec * texture(textureSampler, textureCoord);
+    vec4 ambient = vec4(0.025, 0.025, 0.025, 1.0) * color;
+    vec4 diffuse = vec4(1.0, 1.0, 1.0, 1.0) * diff * color;
+    vec4 specular = vec4(1.0, 1.0, 1.0, 1.0) * spec * color;
 
     FragColor = ambient + diffuse + specular;
 }
\ No newline at end of file
@@ -1,18 +1,35 @@
 #version 450
 
+#ifdef PACKED_VERTEX
+// Position normalized to the mesh bounds, octahedron-encoded normal and texture coordinate normalized to the UV bounds
+layout (location = 0) in vec4 inPosition;
+layout (location = 2) in vec2 inTextureCoord;
+layout (location = 3) in vec2 inNormal;
+layout (location = 4) in vec4 inTangent;
+#ifdef VERTEX_COLOR
+layout (location = 1) in vec4 inColor;
+#endif
+#else
 layout (location = 0) in vec3 inPosition;
 layout (location = 1) in vec3 inColor;
 layout (location = 2) in vec2 inTextureCoord;
 layout (location = 3) in vec3 inNormal;
+layout (location = 4) in vec4 inTangent;
+#endif
 
 layout (push_constant) uniform Constants {
     vec3 position;
+    vec4 positionOffset;
+    vec4 positionScale;
+    vec4 textureCoordTransform;
 } constants;
 
 layout (location = 0) out vec3 fragColor;
 layout (location = 1) out vec2 textureCoord;
 layout (location = 2) out vec3 normal;
 layout (location = 3) out vec3 fragPos;
+// Direction of increasing u, w is the handedness of the bitangent
+layout (location = 4) out vec4 tangent;
 
 layout (set = 0, binding = 0) uniform UniformBufferObject {
     mat4 model;
@@ -21,11 +38,35 @@ layout (set = 0, binding = 0) uniform UniformBufferObject {
     mat3 normalInverse;
 } uniformBufferObject;
 
+vec3 DecodeOctahedron(vec2 encoded) {
+    vec3 n = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+    if (n.z < 0.0)
+        n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    return normalize(n);
+}
+
 void main() {
-    gl_Position = uniformBufferObject.projection * uniformBufferObject.view  * vec4(vec3(uniformBufferObject.model * vec4(inPosition, 1.0) + vec4(constants.position, 0.0f)), 1.0);
-    fragColor = inColor;
+#ifdef PACKED_VERTEX
+    vec3 position = constants.positionOffset.xyz + constants.positionScale.xyz * inPosition.xyz;
+    vec2 texCoord = constants.textureCoordTransform.xy + constants.textureCoordTransform.zw * inTextureCoord;
+    vec3 vertexNormal = DecodeOctahedron(inNormal);
+#ifdef VERTEX_COLOR
+    vec3 color = inColor.rgb;
+#else
+    vec3 color = vec3(1.0);
+#endif
+#else
+    vec3 position = inPosition;
+    vec2 texCoord = inTextureCoord;
+    vec3 vertexNormal = inNormal;
+    vec3 color = inColor;
+#endif
+
+    gl_Position = uniformBufferObject.projection * uniformBufferObject.view  * vec4(vec3(uniformBufferObject.model * vec4(position, 1.0) + vec4(constants.position, 0.0f)), 1.0);
+    fragColor = color;
 
-    textureCoord = inTextureCoord;
-    normal = uniformBufferObject.normalInverse * inNormal;
-    fragPos = vec3(vec4(inPosition, 1.0) * uniformBufferObject.model);
+    textureCoord = texCoord;
+    normal = uniformBufferObject.normalInverse * vertexNormal;
+    tangent = vec4(mat3(uniformBufferObject.model) * inTangent.xyz, inTangent.w < 0.0 ? -1.0 : 1.0);
+    fragPos = vec3(vec4(position, 1.0) * uniformBufferObject.model);
 }